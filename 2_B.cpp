@@ -1,34 +1,419 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
-#include <cstddef> 
 
-void compute_sum_of_lowest_prime_divisors(std::size_t n) {
-    std::vector<std::size_t> lowest_prime_divisor(n + 1, 0);
+constexpr std::size_t kSegmentLength = 1 << 17;
+constexpr std::uint64_t kBatchSieveLimit = std::uint64_t{1} << 32;
+constexpr long double kSublinearStepsPerSieveStep = 1.0L;
+
+std::uint64_t integer_sqrt(std::uint64_t n) {
+    std::uint64_t root = static_cast<std::uint64_t>(std::sqrt(static_cast<long double>(n)));
+    while (root * root > n) {
+        --root;
+    }
+    while ((root + 1) * (root + 1) <= n) {
+        ++root;
+    }
+    return root;
+}
+
+std::vector<std::uint32_t> collect_odd_primes(std::uint32_t limit) {
+    std::vector<bool> is_composite(limit + 1, false);
+    std::vector<std::uint32_t> primes;
+    for (std::uint32_t i = 3; i <= limit; i += 2) {
+        if (is_composite[i]) {
+            continue;
+        }
+        primes.push_back(i);
+        for (std::uint64_t j = std::uint64_t{i} * i; j <= limit; j += 2 * i) {
+            is_composite[j] = true;
+        }
+    }
+    return primes;
+}
+
+std::vector<std::uint64_t> first_odd_multiples(std::uint64_t low,
+                                               const std::vector<std::uint32_t>& primes) {
+    std::vector<std::uint64_t> next_multiple(primes.size());
+    for (std::size_t k = 0; k < primes.size(); ++k) {
+        const std::uint64_t p = primes[k];
+        std::uint64_t start = std::max(p * p, (low + p - 1) / p * p);
+        if (start % 2 == 0) {
+            start += p;
+        }
+        next_multiple[k] = start;
+    }
+    return next_multiple;
+}
+
+// Splits the odd numbers in [3, n] into one contiguous [low, high) range per worker.
+std::vector<std::pair<std::uint64_t, std::uint64_t>> split_odd_range(std::uint64_t n,
+                                                                     unsigned thread_count) {
+    const std::uint64_t odd_count = (n - 1) / 2;
+    const std::uint64_t threads =
+        std::clamp<std::uint64_t>(thread_count, 1, odd_count / kSegmentLength + 1);
+    const std::uint64_t odds_per_thread = (odd_count + threads - 1) / threads;
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+    for (std::uint64_t t = 0; t < threads; ++t) {
+        const std::uint64_t low = 3 + 2 * t * odds_per_thread;
+        const std::uint64_t high = std::min(n + 1, low + 2 * odds_per_thread);
+        if (low >= high) {
+            break;
+        }
+        ranges.emplace_back(low, high);
+    }
+    return ranges;
+}
+
+unsigned long long sum_over_odd_range(std::uint64_t low, std::uint64_t high,
+                                      const std::vector<std::uint32_t>& primes) {
+    unsigned long long partial_sum = 0;
+    std::vector<std::uint64_t> next_multiple = first_odd_multiples(low, primes);
+
+    std::vector<std::uint8_t> is_marked(kSegmentLength);
+    for (std::uint64_t segment_low = low; segment_low < high; segment_low += 2 * kSegmentLength) {
+        const std::uint64_t segment_high = std::min(high, segment_low + 2 * kSegmentLength);
+        std::fill(is_marked.begin(), is_marked.end(), 0);
+        for (std::size_t k = 0; k < primes.size(); ++k) {
+            const std::uint64_t p = primes[k];
+            if (p * p >= segment_high) {
+                break;
+            }
+            std::uint64_t j = next_multiple[k];
+            for (; j < segment_high; j += 2 * p) {
+                std::uint8_t& slot = is_marked[(j - segment_low) / 2];
+                partial_sum += p * (1 - slot);
+                slot = 1;
+            }
+            next_multiple[k] = j;
+        }
+    }
+    return partial_sum;
+}
+
+unsigned long long sum_of_lowest_prime_divisors(std::uint64_t n, unsigned thread_count) {
+    if (n < 4) {
+        return 0;
+    }
+    unsigned long long sum_of_lowest_prime_divisors = 2 * (n / 2 - 1);
 
-    for (std::size_t i = 2; i <= n; ++i) {
-        if (lowest_prime_divisor[i] == 0) {
-            for (std::size_t j = i * i; j <= n; j += i) {
-                if (lowest_prime_divisor[j] == 0) {
-                    lowest_prime_divisor[j] = i;
-                }
+    const auto primes = collect_odd_primes(static_cast<std::uint32_t>(integer_sqrt(n)));
+    const auto ranges = split_odd_range(n, thread_count);
+    std::vector<unsigned long long> partial_sums(ranges.size(), 0);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < ranges.size(); ++t) {
+        workers.emplace_back([&partial_sums, &primes, &ranges, t] {
+            partial_sums[t] = sum_over_odd_range(ranges[t].first, ranges[t].second, primes);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (unsigned long long partial_sum : partial_sums) {
+        sum_of_lowest_prime_divisors += partial_sum;
+    }
+    return sum_of_lowest_prime_divisors;
+}
+
+constexpr std::uint64_t kWheelModulus = 30;
+constexpr std::uint64_t kWheelResidues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+constexpr std::int8_t kWheelPosition[kWheelModulus] = {
+    -1, 0,  -1, -1, -1, -1, -1, 1,  -1, -1, -1, 2,  -1, 3,  -1,
+    -1, -1, 4,  -1, 5,  -1, -1, -1, 6,  -1, -1, -1, -1, -1, 7};
+
+std::uint64_t wheel_index(std::uint64_t value) {
+    return value / kWheelModulus * 8 + kWheelPosition[value % kWheelModulus];
+}
+
+std::uint64_t wheel_value(std::uint64_t index) {
+    return index / 8 * kWheelModulus + kWheelResidues[index % 8];
+}
+
+unsigned long long sum_over_wheel_spokes(std::uint64_t n) {
+    unsigned long long wheel_sum = 2 * (n / 2 - 1);
+    if (n >= 9) {
+        wheel_sum += 3 * (n / 3 - n / 6 - 1);
+    }
+    if (n >= 25) {
+        wheel_sum += 5 * (n / 5 - n / 10 - n / 15 + n / 30 - 1);
+    }
+    return wheel_sum;
+}
+
+template <typename Factor>
+unsigned long long linear_sieve_over_wheel(std::uint64_t n) {
+    const std::uint64_t cofactor_limit = n / 7;
+    std::vector<Factor> lowest_prime_divisor(cofactor_limit / kWheelModulus * 8 + 8, 0);
+    std::vector<std::uint64_t> primes;
+    const std::uint64_t root = integer_sqrt(n);
+    unsigned long long sum_of_lowest_prime_divisors = 0;
+
+    for (std::uint64_t index = 1;; ++index) {
+        const std::uint64_t i = wheel_value(index);
+        if (i > cofactor_limit) {
+            break;
+        }
+        std::uint64_t smallest_factor = lowest_prime_divisor[index];
+        if (smallest_factor == 0) {
+            smallest_factor = i;
+            if (i <= root) {
+                primes.push_back(i);
+            }
+        }
+        for (std::uint64_t p : primes) {
+            if (p > smallest_factor || i * p > n) {
+                break;
+            }
+            if (i * p <= cofactor_limit) {
+                lowest_prime_divisor[wheel_index(i * p)] = static_cast<Factor>(p);
             }
-            lowest_prime_divisor[i] = i;
+            sum_of_lowest_prime_divisors += p;
+        }
+    }
+    return sum_of_lowest_prime_divisors;
+}
+
+unsigned long long linear_sum_of_lowest_prime_divisors(std::uint64_t n) {
+    if (n < 4) {
+        return 0;
+    }
+    const unsigned long long wheel_sum = sum_over_wheel_spokes(n);
+    if (n < 49) {
+        return wheel_sum;
+    }
+    if (integer_sqrt(n) <= UINT16_MAX) {
+        return wheel_sum + linear_sieve_over_wheel<std::uint16_t>(n);
+    }
+    return wheel_sum + linear_sieve_over_wheel<std::uint32_t>(n);
+}
+
+void run_scaling_benchmark(std::uint64_t n) {
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    double serial_seconds = 0;
+    unsigned long long serial_sum = 0;
+    for (unsigned threads = 1;; threads = std::min(2 * threads, max_threads)) {
+        const auto start = std::chrono::steady_clock::now();
+        const unsigned long long sum = sum_of_lowest_prime_divisors(n, threads);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (threads == 1) {
+            serial_seconds = elapsed.count();
+            serial_sum = sum;
         }
+        std::cout << "threads " << threads << ": " << elapsed.count() << " s, speedup "
+                  << serial_seconds / elapsed.count() << (sum == serial_sum ? "" : ", MISMATCH")
+                  << "\n";
+        if (threads == max_threads) {
+            break;
+        }
+    }
+}
+
+unsigned long long sublinear_sum_of_lowest_prime_divisors(std::uint64_t n) {
+    if (n < 4) {
+        return 0;
+    }
+    const std::uint64_t root = integer_sqrt(n);
+    std::vector<std::uint64_t> small_count(root + 1, 0);
+    std::vector<std::uint64_t> large_count(root + 1, 0);
+    for (std::uint64_t v = 1; v <= root; ++v) {
+        small_count[v] = v - 1;
+        large_count[v] = n / v - 1;
     }
 
     unsigned long long sum_of_lowest_prime_divisors = 0;
-    for (std::size_t i = 3; i <= n; ++i) {
-        if (lowest_prime_divisor[i] != i) {
-            sum_of_lowest_prime_divisors += lowest_prime_divisor[i];
+    for (std::uint64_t p = 2; p <= root; ++p) {
+        if (small_count[p] == small_count[p - 1]) {
+            continue;
+        }
+        const std::uint64_t primes_below = small_count[p - 1];
+        const std::uint64_t quotient = n / p;
+        const std::uint64_t rough_count =
+            (quotient <= root ? small_count[quotient] : large_count[p]) - primes_below;
+        sum_of_lowest_prime_divisors += p * rough_count;
+
+        const std::uint64_t p_square = p * p;
+        const std::uint64_t k_limit = std::min(root, n / p_square);
+        for (std::uint64_t k = 1; k <= k_limit; ++k) {
+            const std::uint64_t kp = k * p;
+            const std::uint64_t count = kp <= root ? large_count[kp] : small_count[n / kp];
+            large_count[k] -= count - primes_below;
+        }
+        for (std::uint64_t v = root; v >= p_square; --v) {
+            small_count[v] -= small_count[v / p] - primes_below;
+        }
+    }
+    return sum_of_lowest_prime_divisors;
+}
+
+bool cross_check_with_sieve(std::uint64_t limit) {
+    std::vector<std::uint64_t> values;
+    for (std::uint64_t n = 0; n <= std::min<std::uint64_t>(limit, 2000); ++n) {
+        values.push_back(n);
+    }
+    for (std::uint64_t n = 10000; n <= limit; n *= 10) {
+        values.push_back(n);
+        values.push_back(n + 7);
+    }
+
+    bool all_equal = true;
+    for (std::uint64_t n : values) {
+        const unsigned long long sieved = sum_of_lowest_prime_divisors(n, 1);
+        const unsigned long long counted = sublinear_sum_of_lowest_prime_divisors(n);
+        const unsigned long long linear = linear_sum_of_lowest_prime_divisors(n);
+        if (sieved != counted || sieved != linear) {
+            std::cout << "n = " << n << ": sieve " << sieved << ", sublinear " << counted
+                      << ", linear " << linear << "\n";
+            all_equal = false;
+        }
+    }
+    std::cout << (all_equal ? "OK" : "MISMATCH") << "\n";
+    return all_equal;
+}
+
+void compute_sum_of_lowest_prime_divisors(std::size_t n) {
+    std::cout << sublinear_sum_of_lowest_prime_divisors(n) << "\n";
+}
+
+// For every sorted bound, sums the lowest prime divisors of the odd numbers in [low, min(bound, high)).
+std::vector<unsigned long long> prefix_sums_over_odd_range(std::uint64_t low, std::uint64_t high,
+                                                           const std::vector<std::uint32_t>& primes,
+                                                           const std::vector<std::uint64_t>& bounds) {
+    std::vector<std::uint64_t> next_multiple = first_odd_multiples(low, primes);
+    std::vector<unsigned long long> prefix_sums(bounds.size(), 0);
+    std::size_t answered = std::lower_bound(bounds.begin(), bounds.end(), low) - bounds.begin();
+    unsigned long long odd_sum = 0;
+
+    std::vector<std::uint32_t> marked_by(kSegmentLength);
+    for (std::uint64_t segment_low = low; segment_low < high; segment_low += 2 * kSegmentLength) {
+        const std::uint64_t segment_high = std::min(high, segment_low + 2 * kSegmentLength);
+        std::fill(marked_by.begin(), marked_by.end(), 0);
+        for (std::size_t k = 0; k < primes.size(); ++k) {
+            const std::uint32_t p = primes[k];
+            if (std::uint64_t{p} * p >= segment_high) {
+                break;
+            }
+            std::uint64_t j = next_multiple[k];
+            for (; j < segment_high; j += 2 * p) {
+                std::uint32_t& slot = marked_by[(j - segment_low) / 2];
+                slot = slot == 0 ? p : slot;
+            }
+            next_multiple[k] = j;
+        }
+        for (std::uint64_t value = segment_low; value < segment_high; value += 2) {
+            for (; answered < bounds.size() && bounds[answered] <= value; ++answered) {
+                prefix_sums[answered] = odd_sum;
+            }
+            odd_sum += marked_by[(value - segment_low) / 2];
+        }
+    }
+    for (; answered < bounds.size(); ++answered) {
+        prefix_sums[answered] = odd_sum;
+    }
+    return prefix_sums;
+}
+
+std::vector<unsigned long long> sieve_sums_for_queries(const std::vector<std::uint64_t>& queries,
+                                                       unsigned thread_count) {
+    std::vector<std::uint64_t> bounds;
+    for (std::uint64_t n : queries) {
+        bounds.push_back(n + 1);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    const std::uint64_t max_n = bounds.empty() ? 0 : bounds.back() - 1;
+
+    std::vector<unsigned long long> odd_sums(bounds.size(), 0);
+    if (max_n >= 3) {
+        const auto primes = collect_odd_primes(static_cast<std::uint32_t>(integer_sqrt(max_n)));
+        const auto ranges = split_odd_range(max_n, thread_count);
+        std::vector<std::vector<unsigned long long>> partial_sums(ranges.size());
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < ranges.size(); ++t) {
+            workers.emplace_back([&partial_sums, &primes, &ranges, &bounds, t] {
+                partial_sums[t] = prefix_sums_over_odd_range(ranges[t].first, ranges[t].second,
+                                                             primes, bounds);
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        for (const auto& range_sums : partial_sums) {
+            for (std::size_t i = 0; i < bounds.size(); ++i) {
+                odd_sums[i] += range_sums[i];
+            }
         }
     }
 
-    std::cout << sum_of_lowest_prime_divisors << "\n";
+    std::vector<unsigned long long> answers;
+    for (std::uint64_t n : queries) {
+        const std::size_t i = std::lower_bound(bounds.begin(), bounds.end(), n + 1) - bounds.begin();
+        answers.push_back(n < 4 ? 0 : 2 * (n / 2 - 1) + odd_sums[i]);
+    }
+    return answers;
+}
+
+// The sieve touches every number up to the largest query, while the counting engine costs
+// about n^{3/4} per query; sieve only when that is the cheaper of the two.
+bool batch_sieve_is_cheaper(const std::vector<std::uint64_t>& queries, unsigned thread_count) {
+    const std::uint64_t max_n =
+        queries.empty() ? 0 : *std::max_element(queries.begin(), queries.end());
+    if (max_n > kBatchSieveLimit) {
+        return false;
+    }
+    long double sublinear_cost = 0;
+    for (std::uint64_t n : queries) {
+        sublinear_cost += std::pow(static_cast<long double>(n), 0.75L);
+    }
+    const long double sieve_cost = static_cast<long double>(max_n) / thread_count;
+    return sieve_cost < kSublinearStepsPerSieveStep * sublinear_cost;
+}
+
+void compute_sums_for_queries(const std::vector<std::uint64_t>& queries) {
+    const unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+    if (!batch_sieve_is_cheaper(queries, thread_count)) {
+        for (std::uint64_t n : queries) {
+            std::cout << sublinear_sum_of_lowest_prime_divisors(n) << "\n";
+        }
+        return;
+    }
+    for (unsigned long long answer : sieve_sums_for_queries(queries, thread_count)) {
+        std::cout << answer << "\n";
+    }
 }
 
-int main() {
-    std::size_t n;
-    std::cin >> n;
-    compute_sum_of_lowest_prime_divisors(n);
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        run_scaling_benchmark(argc > 2 ? std::stoull(argv[2]) : 1000000000ULL);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        return cross_check_with_sieve(argc > 2 ? std::stoull(argv[2]) : 10000000ULL) ? 0 : 1;
+    }
+
+    std::vector<std::uint64_t> queries;
+    for (std::uint64_t n; std::cin >> n;) {
+        queries.push_back(n);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--linear") {
+        for (std::uint64_t n : queries) {
+            std::cout << linear_sum_of_lowest_prime_divisors(n) << "\n";
+        }
+        return 0;
+    }
+    if (queries.size() == 1) {
+        compute_sum_of_lowest_prime_divisors(queries.front());
+        return 0;
+    }
+    compute_sums_for_queries(queries);
     return 0;
 }
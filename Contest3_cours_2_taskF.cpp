@@ -1,10 +1,24 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
 struct Point3D {
     double x;
     double y;
@@ -55,6 +69,93 @@ std::vector<Point3D> ReadPoints3D(int count) {
     return points;
 }
 
+// Triangle mesh in half-edge form: half-edge 3 * f + e runs from
+// vertex_indices[e] to vertex_indices[(e + 1) % 3] of face f, and twin
+// holds the opposite half-edge. Dead faces are recycled through free_faces.
+struct HullMesh {
+    std::vector<Face3D> faces;
+    std::vector<int> twin;
+    std::vector<std::vector<int>> conflict_points;
+    std::vector<int> free_faces;
+};
+
+double DistanceAboveFace(const Face3D& face, const std::vector<Point3D>& points, int point_index) {
+    const Point3D base = points[face.vertex_indices[0]];
+    return face.normal_x * (points[point_index].x - base.x) +
+           face.normal_y * (points[point_index].y - base.y) +
+           face.normal_z * (points[point_index].z - base.z);
+}
+
+int AddFace(HullMesh& mesh, const std::vector<Point3D>& points, int a, int b, int c) {
+    const Point3D normal = CrossProduct(Subtract(points[b], points[a]), Subtract(points[c], points[a]));
+    const Face3D face = {{{a, b, c}}, normal.x, normal.y, normal.z, true};
+    if (!mesh.free_faces.empty()) {
+        const int face_index = mesh.free_faces.back();
+        mesh.free_faces.pop_back();
+        mesh.faces[face_index] = face;
+        return face_index;
+    }
+    mesh.faces.push_back(face);
+    mesh.twin.insert(mesh.twin.end(), 3, -1);
+    mesh.conflict_points.emplace_back();
+    return static_cast<int>(mesh.faces.size()) - 1;
+}
+
+void LinkTwins(HullMesh& mesh, int half_edge, int opposite) {
+    mesh.twin[half_edge] = opposite;
+    mesh.twin[opposite] = half_edge;
+}
+
+// Spreads the low 21 bits of value so that three of them interleave.
+uint64_t SpreadBits(uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffffULL;
+    value = (value | value << 16) & 0x1f0000ff0000ffULL;
+    value = (value | value << 8) & 0x100f00f00f00f00fULL;
+    value = (value | value << 4) & 0x10c30c30c30c30c3ULL;
+    value = (value | value << 2) & 0x1249249249249249ULL;
+    return value;
+}
+
+// Biased randomized insertion order: a random sample of doubling rounds,
+// each sorted along a Morton curve, keeps the expected bound of a random
+// order while consecutive insertions touch nearby faces.
+void ApplyBiasedRandomOrder(std::vector<int>& order, const std::vector<Point3D>& points) {
+    std::mt19937 random_engine(20240917);
+    std::shuffle(order.begin(), order.end(), random_engine);
+    if (order.empty()) return;
+    
+    Point3D low = points[order[0]];
+    Point3D high = low;
+    for (const int index : order) {
+        low = {std::min(low.x, points[index].x), std::min(low.y, points[index].y), std::min(low.z, points[index].z)};
+        high = {std::max(high.x, points[index].x), std::max(high.y, points[index].y), std::max(high.z, points[index].z)};
+    }
+    const double extent = std::max({high.x - low.x, high.y - low.y, high.z - low.z, kTolerance});
+    const double scale = ((1 << 21) - 1) / extent;
+    auto morton_key = [&](int index) {
+        const Point3D& p = points[index];
+        return SpreadBits(static_cast<uint64_t>((p.x - low.x) * scale)) |
+               SpreadBits(static_cast<uint64_t>((p.y - low.y) * scale)) << 1 |
+               SpreadBits(static_cast<uint64_t>((p.z - low.z) * scale)) << 2;
+    };
+    
+    std::vector<std::pair<uint64_t, int>> keyed(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        keyed[i] = {morton_key(order[i]), order[i]};
+    }
+    for (size_t begin = 0, size = 64; begin < keyed.size(); begin += size, size *= 2) {
+        const size_t end = std::min(keyed.size(), begin + size);
+        std::sort(keyed.begin() + begin, keyed.begin() + end);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = keyed[i].second;
+    }
+}
+
+// Randomized incremental construction with a conflict graph: every
+// pending point knows the faces it sees and every face knows the points
+// that see it, so inserting a point touches only its visible cap.
 std::vector<Face3D> BuildConvexHull(const std::vector<Point3D>& points) {
     const int num_points = points.size();
     
@@ -67,9 +168,10 @@ std::vector<Face3D> BuildConvexHull(const std::vector<Point3D>& points) {
     }
     
     int third_noncolinear_point = second_distinct_point + 1;
-    while (third_noncolinear_point < num_points && 
-           DotProduct(CrossProduct(Subtract(points[second_distinct_point], points[initial_point]),
-                       CrossProduct(Subtract(points[third_noncolinear_point], points[initial_point])) < kTolerance) {
+    while (third_noncolinear_point < num_points) {
+        const Point3D normal = CrossProduct(Subtract(points[second_distinct_point], points[initial_point]),
+                                            Subtract(points[third_noncolinear_point], points[initial_point]));
+        if (DotProduct(normal, normal) >= kTolerance) break;
         ++third_noncolinear_point;
     }
     
@@ -80,30 +182,19 @@ std::vector<Face3D> BuildConvexHull(const std::vector<Point3D>& points) {
                                   Subtract(points[fourth_noncoplanar_point], points[initial_point]))) < kTolerance) {
         ++fourth_noncoplanar_point;
     }
+    if (fourth_noncoplanar_point >= num_points) return {};
     
-    std::array<std::array<int, 3>, 4> face_vertices = {{
-        {{initial_point, second_distinct_point, third_noncolinear_point}},
-        {{initial_point, third_noncolinear_point, fourth_noncoplanar_point}},
-        {{second_distinct_point, fourth_noncoplanar_point, third_noncolinear_point}},
-        {{second_distinct_point, initial_point, fourth_noncoplanar_point}}
-    }};
-    
-    std::vector<Face3D> convex_hull;
-    convex_hull.reserve(num_points * 2);
-    for (const auto& face : face_vertices) {
-        Point3D normal = CrossProduct(
-            Subtract(points[face[1]], points[face[0]]),
-            Subtract(points[face[2]], points[face[0]])
-        );
-        convex_hull.push_back({
-            face,
-            normal.x,
-            normal.y,
-            normal.z,
-            true
-        });
+    if (DotProduct(CrossProduct(Subtract(points[second_distinct_point], points[initial_point]),
+                                Subtract(points[third_noncolinear_point], points[initial_point])),
+                   Subtract(points[fourth_noncoplanar_point], points[initial_point])) > 0) {
+        std::swap(second_distinct_point, third_noncolinear_point);
     }
     
+    std::vector<int> original_index = {
+        initial_point, second_distinct_point, third_noncolinear_point, fourth_noncoplanar_point
+    };
+    std::vector<int> insertion_order;
+    insertion_order.reserve(num_points);
     for (int point_index = 0; point_index < num_points; ++point_index) {
         if (point_index == initial_point || 
             point_index == second_distinct_point || 
@@ -111,66 +202,212 @@ std::vector<Face3D> BuildConvexHull(const std::vector<Point3D>& points) {
             point_index == fourth_noncoplanar_point) {
             continue;
         }
-        
-        std::vector<bool> is_visible(convex_hull.size(), false);
-        bool has_visible = false;
-        for (size_t face_index = 0; face_index < convex_hull.size(); ++face_index) {
-            const Face3D& face = convex_hull[face_index];
-            if (!face.is_active) continue;
-            
-            const Point3D base = points[face.vertex_indices[0]];
-            const double distance = face.normal_x * (points[point_index].x - base.x) +
-                                   face.normal_y * (points[point_index].y - base.y) +
-                                   face.normal_z * (points[point_index].z - base.z);
-            
-            if (distance > kTolerance) {
-                is_visible[face_index] = true;
-                has_visible = true;
+        insertion_order.push_back(point_index);
+    }
+    ApplyBiasedRandomOrder(insertion_order, points);
+    original_index.insert(original_index.end(), insertion_order.begin(), insertion_order.end());
+    
+    // The mesh works on points relabelled in insertion order, so conflict
+    // lists, which stay roughly sorted, are scanned with forward strides.
+    std::vector<Point3D> ordered;
+    ordered.reserve(num_points);
+    for (const int index : original_index) {
+        ordered.push_back(points[index]);
+    }
+    
+    std::array<std::array<int, 3>, 4> face_vertices = {{
+        {{0, 1, 2}},
+        {{0, 2, 3}},
+        {{1, 3, 2}},
+        {{1, 0, 3}}
+    }};
+    
+    HullMesh mesh;
+    mesh.faces.reserve(num_points * 2);
+    for (const auto& face : face_vertices) {
+        AddFace(mesh, ordered, face[0], face[1], face[2]);
+    }
+    for (int half_edge = 0; half_edge < 12; ++half_edge) {
+        const auto& face = mesh.faces[half_edge / 3].vertex_indices;
+        for (int other = 0; other < 12; ++other) {
+            const auto& other_face = mesh.faces[other / 3].vertex_indices;
+            if (face[half_edge % 3] == other_face[(other + 1) % 3] &&
+                face[(half_edge + 1) % 3] == other_face[other % 3]) {
+                mesh.twin[half_edge] = other;
+            }
+        }
+    }
+    
+    std::vector<std::vector<int>> conflict_faces(num_points);
+    for (int point_index = 4; point_index < num_points; ++point_index) {
+        for (int face_index = 0; face_index < 4; ++face_index) {
+            if (DistanceAboveFace(mesh.faces[face_index], ordered, point_index) > kTolerance) {
+                conflict_faces[point_index].push_back(face_index);
+                mesh.conflict_points[face_index].push_back(point_index);
             }
         }
+    }
+    
+    struct HorizonEdge {
+        int outer_half_edge;
+        int inner_face;
+    };
+    std::vector<int> visible_faces;
+    std::vector<HorizonEdge> horizon;
+    std::vector<int> visited_by(mesh.faces.size(), -1);
+    std::vector<int> candidate_stamp(num_points, -1);
+    int stamp = 0;
+    std::vector<int> cone_face_from(num_points, -1);
+    
+    for (int point_index = 4; point_index < num_points; ++point_index) {
+        visible_faces.swap(conflict_faces[point_index]);
+        std::vector<int>().swap(conflict_faces[point_index]);
+        if (visible_faces.empty()) continue;
         
-        if (!has_visible) continue;
+        visited_by.resize(mesh.faces.size(), -1);
+        for (const int face_index : visible_faces) {
+            visited_by[face_index] = point_index;
+        }
         
-        std::vector<std::pair<int, int>> boundary_edges;
-        for (size_t face_index = 0; face_index < convex_hull.size(); ++face_index) {
-            if (!is_visible[face_index]) continue;
-            
-            const Face3D& face = convex_hull[face_index];
+        horizon.clear();
+        for (const int face_index : visible_faces) {
             for (int edge = 0; edge < 3; ++edge) {
-                int u = face.vertex_indices[edge];
-                int v = face.vertex_indices[(edge + 1) % 3];
-                
-                bool is_removed = false;
-                for (auto it = boundary_edges.begin(); it != boundary_edges.end(); ++it) {
-                    if (it->first == v && it->second == u) {
-                        boundary_edges.erase(it);
-                        is_removed = true;
-                        break;
-                    }
+                const int outer = mesh.twin[3 * face_index + edge];
+                if (visited_by[outer / 3] != point_index) {
+                    horizon.push_back({outer, face_index});
                 }
-                if (!is_removed) {
-                    boundary_edges.emplace_back(u, v);
+            }
+        }
+        
+        for (const HorizonEdge& edge : horizon) {
+            const auto& outer_face = mesh.faces[edge.outer_half_edge / 3].vertex_indices;
+            const int u = outer_face[(edge.outer_half_edge + 1) % 3];
+            const int v = outer_face[edge.outer_half_edge % 3];
+            const int face_index = AddFace(mesh, ordered, u, v, point_index);
+            LinkTwins(mesh, 3 * face_index, edge.outer_half_edge);
+            cone_face_from[u] = face_index;
+            
+            const Face3D& face = mesh.faces[face_index];
+            ++stamp;
+            candidate_stamp[point_index] = stamp;
+            for (const int source : {edge.inner_face, edge.outer_half_edge / 3}) {
+                for (const int candidate : mesh.conflict_points[source]) {
+                    if (candidate_stamp[candidate] == stamp) continue;
+                    candidate_stamp[candidate] = stamp;
+                    if (DistanceAboveFace(face, ordered, candidate) > kTolerance) {
+                        conflict_faces[candidate].push_back(face_index);
+                        mesh.conflict_points[face_index].push_back(candidate);
+                    }
                 }
             }
-            convex_hull[face_index].is_active = false;
         }
         
-        for (const auto& edge : boundary_edges) {
-            Point3D normal = CrossProduct(
-                Subtract(points[edge.second], points[edge.first]),
-                Subtract(points[point_index], points[edge.first])
-            );
-            convex_hull.push_back({
-                {edge.first, edge.second, point_index},
-                normal.x,
-                normal.y,
-                normal.z,
-                true
-            });
+        for (const HorizonEdge& edge : horizon) {
+            const int face_index = mesh.twin[edge.outer_half_edge] / 3;
+            const int next_face = cone_face_from[mesh.faces[face_index].vertex_indices[1]];
+            LinkTwins(mesh, 3 * face_index + 1, 3 * next_face + 2);
+        }
+        
+        for (const int face_index : visible_faces) {
+            for (const int candidate : mesh.conflict_points[face_index]) {
+                if (candidate == point_index) continue;
+                auto& faces = conflict_faces[candidate];
+                *std::find(faces.begin(), faces.end(), face_index) = faces.back();
+                faces.pop_back();
+            }
+            mesh.faces[face_index].is_active = false;
+            mesh.conflict_points[face_index].clear();
+            mesh.free_faces.push_back(face_index);
+        }
+    }
+    
+    for (Face3D& face : mesh.faces) {
+        for (int& vertex : face.vertex_indices) {
+            vertex = original_index[vertex];
+        }
+    }
+    return mesh.faces;
+}
+
+// Hull of points[subset]; the faces refer to indices of points.
+std::vector<Face3D> BuildConvexHullOfSubset(const std::vector<Point3D>& points, const std::vector<int>& subset) {
+    std::vector<Point3D> subset_points;
+    subset_points.reserve(subset.size());
+    for (const int index : subset) {
+        subset_points.push_back(points[index]);
+    }
+    std::vector<Face3D> faces;
+    for (Face3D face : BuildConvexHull(subset_points)) {
+        if (!face.is_active) continue;
+        for (int& vertex : face.vertex_indices) {
+            vertex = subset[vertex];
         }
+        faces.push_back(face);
     }
+    return faces;
+}
+
+// Points of the subset that survive as hull vertices; only they can be
+// vertices of the hull of any superset. A flat subset is kept whole.
+std::vector<int> HullVertexIndices(const std::vector<Point3D>& points, const std::vector<int>& subset) {
+    const auto faces = BuildConvexHullOfSubset(points, subset);
+    if (faces.empty()) return subset;
+    std::vector<int> vertices;
+    vertices.reserve(faces.size() / 2 + 2);
+    for (const Face3D& face : faces) {
+        vertices.insert(vertices.end(), face.vertex_indices.begin(), face.vertex_indices.end());
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    return vertices;
+}
+
+static constexpr int kParallelHullMinPoints = 1 << 15;
+
+// Divide and conquer across threads: every slice is reduced to its hull
+// vertices concurrently, and neighbouring survivor sets are merged
+// pairwise and reduced again while that still halves the work. The last
+// set is built serially, so inputs whose points are nearly all extreme
+// (e.g. on a sphere) gain little.
+std::vector<Face3D> BuildConvexHullParallel(const std::vector<Point3D>& points, unsigned thread_count) {
+    const int num_points = points.size();
+    const int slices = std::min<int>(std::max(thread_count, 1u), num_points / kParallelHullMinPoints);
+    if (slices <= 1) return BuildConvexHull(points);
     
-    return convex_hull;
+    std::vector<std::vector<int>> parts(slices);
+    for (int slice = 0; slice < slices; ++slice) {
+        const int begin = static_cast<long long>(num_points) * slice / slices;
+        const int end = static_cast<long long>(num_points) * (slice + 1) / slices;
+        for (int index = begin; index < end; ++index) {
+            parts[slice].push_back(index);
+        }
+    }
+    
+    size_t remaining = num_points;
+    while (parts.size() > 1) {
+        std::vector<std::thread> pool;
+        for (auto& part : parts) {
+            pool.emplace_back([&points, &part] { part = HullVertexIndices(points, part); });
+        }
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        
+        size_t survivors = 0;
+        for (const auto& part : parts) {
+            survivors += part.size();
+        }
+        const bool keeps_shrinking = 2 * survivors < remaining;
+        remaining = survivors;
+        
+        std::vector<std::vector<int>> merged(keeps_shrinking ? (parts.size() + 1) / 2 : 1);
+        for (size_t i = 0; i < parts.size(); ++i) {
+            auto& target = merged[keeps_shrinking ? i / 2 : 0];
+            target.insert(target.end(), parts[i].begin(), parts[i].end());
+        }
+        parts.swap(merged);
+    }
+    return BuildConvexHullOfSubset(points, parts[0]);
 }
 
 std::vector<Plane3D> ExtractPlanes(const std::vector<Face3D>& faces, const std::vector<Point3D>& points) {
@@ -194,40 +431,398 @@ std::vector<Plane3D> ExtractPlanes(const std::vector<Face3D>& faces, const std::
     return planes;
 }
 
-std::vector<double> CalculateDistances(const std::vector<Plane3D>& planes, int query_count) {
-    std::vector<double> distances;
-    distances.reserve(query_count);
-    for (int query_index = 0; query_index < query_count; ++query_index) {
-        Point3D query_point;
-        std::cin >> query_point.x >> query_point.y >> query_point.z;
-        
-        double min_distance = std::numeric_limits<double>::max();
-        for (const Plane3D& plane : planes) {
-            const double value = plane.a * query_point.x + plane.b * query_point.y + 
-                                plane.c * query_point.z + plane.d;
-            const double distance = std::abs(value);
-            if (distance < min_distance) {
-                min_distance = distance;
+// Planes split into coordinate arrays for the query kernel, padded to a
+// multiple of kPlaneLanes with planes that are infinitely far away.
+struct PlaneArrays {
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<double> c;
+    std::vector<double> d;
+};
+
+static constexpr int kPlaneLanes = 4;
+static constexpr int kPlaneTileSize = 1024;
+static constexpr int kQueryChunkSize = 4096;
+
+PlaneArrays ToPlaneArrays(const std::vector<Plane3D>& planes) {
+    const size_t padded = (planes.size() + kPlaneLanes - 1) / kPlaneLanes * kPlaneLanes;
+    PlaneArrays arrays;
+    arrays.a.assign(padded, 0.0);
+    arrays.b.assign(padded, 0.0);
+    arrays.c.assign(padded, 0.0);
+    arrays.d.assign(padded, std::numeric_limits<double>::infinity());
+    for (size_t i = 0; i < planes.size(); ++i) {
+        arrays.a[i] = planes[i].a;
+        arrays.b[i] = planes[i].b;
+        arrays.c[i] = planes[i].c;
+        arrays.d[i] = planes[i].d;
+    }
+    return arrays;
+}
+
+void TileMinDistancesScalar(const PlaneArrays& planes, size_t begin, size_t end,
+                            const Point3D* queries, int count, double* min_distances) {
+    for (int q = 0; q < count; ++q) {
+        double min_distance = min_distances[q];
+        for (size_t i = begin; i < end; ++i) {
+            const double value = planes.a[i] * queries[q].x + planes.b[i] * queries[q].y +
+                                planes.c[i] * queries[q].z + planes.d[i];
+            min_distance = std::min(min_distance, std::abs(value));
+        }
+        min_distances[q] = min_distance;
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+// Four queries share every plane load. Products and sums are rounded in
+// the same order as the scalar loop (no FMA), so results match it bit
+// for bit.
+__attribute__((target("avx2")))
+void TileMinDistancesAvx2(const PlaneArrays& planes, size_t begin, size_t end,
+                          const Point3D* queries, int count, double* min_distances) {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    int q = 0;
+    for (; q + 4 <= count; q += 4) {
+        __m256d x[4], y[4], z[4], best[4];
+        for (int k = 0; k < 4; ++k) {
+            x[k] = _mm256_set1_pd(queries[q + k].x);
+            y[k] = _mm256_set1_pd(queries[q + k].y);
+            z[k] = _mm256_set1_pd(queries[q + k].z);
+            best[k] = _mm256_set1_pd(min_distances[q + k]);
+        }
+        for (size_t i = begin; i < end; i += kPlaneLanes) {
+            const __m256d a = _mm256_loadu_pd(&planes.a[i]);
+            const __m256d b = _mm256_loadu_pd(&planes.b[i]);
+            const __m256d c = _mm256_loadu_pd(&planes.c[i]);
+            const __m256d d = _mm256_loadu_pd(&planes.d[i]);
+            for (int k = 0; k < 4; ++k) {
+                __m256d value = _mm256_add_pd(_mm256_mul_pd(a, x[k]), _mm256_mul_pd(b, y[k]));
+                value = _mm256_add_pd(_mm256_add_pd(value, _mm256_mul_pd(c, z[k])), d);
+                best[k] = _mm256_min_pd(best[k], _mm256_andnot_pd(sign_mask, value));
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            alignas(32) double lanes[kPlaneLanes];
+            _mm256_store_pd(lanes, best[k]);
+            min_distances[q + k] = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+        }
+    }
+    TileMinDistancesScalar(planes, begin, end, queries + q, count - q, min_distances + q);
+}
+#endif
+
+// Minimum |ax + by + cz + d| over all planes for each query, walking the
+// planes in tiles that stay in cache while the whole chunk passes over them.
+void ScanPlaneDistances(const PlaneArrays& planes, const Point3D* queries, int count, double* distances) {
+    std::fill(distances, distances + count, std::numeric_limits<double>::max());
+#ifdef HAVE_X86_SIMD
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    for (size_t begin = 0; begin < planes.a.size(); begin += kPlaneTileSize) {
+        const size_t end = std::min(planes.a.size(), begin + kPlaneTileSize);
+#ifdef HAVE_X86_SIMD
+        if (has_avx2) {
+            TileMinDistancesAvx2(planes, begin, end, queries, count, distances);
+            continue;
+        }
+#endif
+        TileMinDistancesScalar(planes, begin, end, queries, count, distances);
+    }
+}
+
+// Node of a tree over the planes seen as dual points (a, b, c, d'), where
+// d' is the offset measured from the index origin. The node bounds its
+// normals by a cone around axis and its offsets by an interval. The left
+// child directly follows its parent; right is -1 for leaves.
+struct PlaneTreeNode {
+    Point3D axis;
+    double cos_spread;
+    double sin_spread;
+    double offset_low;
+    double offset_high;
+    int first;
+    int last;
+    int right;
+};
+
+// Planes in tree order plus the tree. Small plane sets have no tree and
+// are scanned.
+struct PlaneIndex {
+    PlaneArrays planes;
+    std::vector<PlaneTreeNode> nodes;
+    Point3D origin;
+    double scale;
+};
+
+static constexpr int kPlaneLeafSize = 8;
+static constexpr int kPlaneTreeMinPlanes = 2048;
+static constexpr double kPlaneBoundSlack = 1e-9;
+
+int BuildPlaneTreeNodes(PlaneIndex& index, const std::vector<std::array<double, 4>>& dual,
+                        std::vector<int>& order, int first, int last) {
+    std::array<double, 4> low = dual[order[first]];
+    std::array<double, 4> high = low;
+    Point3D axis = {0, 0, 0};
+    for (int i = first; i < last; ++i) {
+        const auto& point = dual[order[i]];
+        for (int k = 0; k < 4; ++k) {
+            low[k] = std::min(low[k], point[k]);
+            high[k] = std::max(high[k], point[k]);
+        }
+        axis = {axis.x + point[0], axis.y + point[1], axis.z + point[2]};
+    }
+    
+    PlaneTreeNode node;
+    const double axis_length = std::sqrt(DotProduct(axis, axis));
+    node.cos_spread = -1;
+    if (axis_length > kTolerance) {
+        node.axis = {axis.x / axis_length, axis.y / axis_length, axis.z / axis_length};
+        node.cos_spread = 1;
+        for (int i = first; i < last; ++i) {
+            const auto& point = dual[order[i]];
+            node.cos_spread = std::min(node.cos_spread, DotProduct(node.axis, {point[0], point[1], point[2]}));
+        }
+        node.cos_spread = std::max(node.cos_spread - kPlaneBoundSlack, -1.0);
+    } else {
+        node.axis = {1, 0, 0};
+    }
+    node.sin_spread = std::sqrt(1 - node.cos_spread * node.cos_spread);
+    node.offset_low = low[3];
+    node.offset_high = high[3];
+    node.first = first;
+    node.last = last;
+    node.right = -1;
+    const int node_index = index.nodes.size();
+    index.nodes.push_back(node);
+    if (last - first <= kPlaneLeafSize) return node_index;
+    
+    // A normal component spread w moves a query's value by up to w times
+    // its distance from the origin, which is about scale.
+    int split = 3;
+    double widest = high[3] - low[3];
+    for (int k = 0; k < 3; ++k) {
+        const double width = (high[k] - low[k]) * index.scale;
+        if (width > widest) {
+            widest = width;
+            split = k;
+        }
+    }
+    const int middle = first + (last - first) / 2;
+    std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last,
+                     [&](int lhs, int rhs) { return dual[lhs][split] < dual[rhs][split]; });
+    BuildPlaneTreeNodes(index, dual, order, first, middle);
+    const int right = BuildPlaneTreeNodes(index, dual, order, middle, last);
+    index.nodes[node_index].right = right;
+    return node_index;
+}
+
+// The origin should lie inside the hull so that queries near it give
+// tight bounds; the centroid of the input points does.
+PlaneIndex BuildPlaneIndex(const std::vector<Plane3D>& planes, const Point3D& origin) {
+    PlaneIndex index;
+    index.origin = origin;
+    index.scale = 0;
+    if (planes.size() < static_cast<size_t>(kPlaneTreeMinPlanes)) {
+        index.planes = ToPlaneArrays(planes);
+        return index;
+    }
+    
+    std::vector<std::array<double, 4>> dual(planes.size());
+    for (size_t i = 0; i < planes.size(); ++i) {
+        const Plane3D& plane = planes[i];
+        dual[i] = {plane.a, plane.b, plane.c, plane.d + plane.a * origin.x + plane.b * origin.y + plane.c * origin.z};
+        index.scale = std::max(index.scale, std::abs(dual[i][3]));
+    }
+    std::vector<int> order(planes.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    BuildPlaneTreeNodes(index, dual, order, 0, order.size());
+    
+    std::vector<Plane3D> ordered;
+    ordered.reserve(planes.size());
+    for (const int i : order) {
+        ordered.push_back(planes[i]);
+    }
+    index.planes = ToPlaneArrays(ordered);
+    return index;
+}
+
+// With theta the angle between the query and the node axis, normals in
+// the cone project onto the query between cos(theta + spread) and
+// cos(theta - spread) times its length.
+double PlaneConeLowerBound(const PlaneTreeNode& node, const Point3D& shifted, double length) {
+    double cos_near = 1;
+    double cos_far = -1;
+    if (length > 0) {
+        const double cos_theta = std::clamp(DotProduct(node.axis, shifted) / length, -1.0, 1.0);
+        const double sin_theta = std::sqrt(1 - cos_theta * cos_theta);
+        if (cos_theta < node.cos_spread) {
+            cos_near = cos_theta * node.cos_spread + sin_theta * node.sin_spread;
+        }
+        if (cos_theta > -node.cos_spread) {
+            cos_far = cos_theta * node.cos_spread - sin_theta * node.sin_spread;
+        }
+    }
+    const double low = length * cos_far + node.offset_low;
+    const double high = length * cos_near + node.offset_high;
+    return low > 0 ? low : (high < 0 ? -high : 0.0);
+}
+
+// Branch and bound, nearer child first. Leaves evaluate the planes exactly
+// as the scan does, and the bounds, computed about the origin, are loosened
+// by a relative slack so that rounding never prunes the minimum.
+double NearestPlaneDistance(const PlaneIndex& index, const Point3D& query) {
+    const Point3D shifted = Subtract(query, index.origin);
+    const double length = std::sqrt(DotProduct(shifted, shifted));
+    const double slack = kPlaneBoundSlack * (1.0 + index.scale + length);
+    const PlaneArrays& planes = index.planes;
+    double best = std::numeric_limits<double>::max();
+    
+    std::array<std::pair<int, double>, 128> stack;
+    int depth = 0;
+    stack[depth++] = {0, PlaneConeLowerBound(index.nodes[0], shifted, length)};
+    while (depth > 0) {
+        const auto [node_index, bound] = stack[--depth];
+        if (bound > best + slack) continue;
+        const PlaneTreeNode& node = index.nodes[node_index];
+        if (node.right < 0) {
+            for (int i = node.first; i < node.last; ++i) {
+                const double value = planes.a[i] * query.x + planes.b[i] * query.y +
+                                    planes.c[i] * query.z + planes.d[i];
+                best = std::min(best, std::abs(value));
             }
+            continue;
+        }
+        std::pair<int, double> near = {node_index + 1, PlaneConeLowerBound(index.nodes[node_index + 1], shifted, length)};
+        std::pair<int, double> far = {node.right, PlaneConeLowerBound(index.nodes[node.right], shifted, length)};
+        if (far.second < near.second) std::swap(near, far);
+        stack[depth++] = far;
+        stack[depth++] = near;
+    }
+    return best;
+}
+
+void MinPlaneDistances(const PlaneIndex& index, const Point3D* queries, int count, double* distances) {
+    if (index.nodes.empty()) {
+        ScanPlaneDistances(index.planes, queries, count, distances);
+        return;
+    }
+    for (int q = 0; q < count; ++q) {
+        distances[q] = NearestPlaneDistance(index, queries[q]);
+    }
+}
+
+// Parses the queries chunk by chunk on the calling thread while the
+// workers answer the chunks already read.
+std::vector<double> CalculateDistances(const PlaneIndex& index, int query_count, unsigned thread_count) {
+    std::vector<double> distances(query_count);
+    std::deque<std::pair<int, std::vector<Point3D>>> pending;
+    std::mutex pending_mutex;
+    std::condition_variable pending_ready;
+    bool parsing_done = false;
+    
+    auto worker = [&] {
+        while (true) {
+            std::unique_lock<std::mutex> lock(pending_mutex);
+            pending_ready.wait(lock, [&] { return !pending.empty() || parsing_done; });
+            if (pending.empty()) return;
+            auto chunk = std::move(pending.front());
+            pending.pop_front();
+            lock.unlock();
+            MinPlaneDistances(index, chunk.second.data(), chunk.second.size(), &distances[chunk.first]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < std::max(thread_count, 1u); ++i) {
+        pool.emplace_back(worker);
+    }
+    
+    for (int first = 0; first < query_count; first += kQueryChunkSize) {
+        auto chunk = ReadPoints3D(std::min(kQueryChunkSize, query_count - first));
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex);
+            pending.emplace_back(first, std::move(chunk));
         }
-        distances.push_back(min_distance);
+        pending_ready.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        parsing_done = true;
+    }
+    pending_ready.notify_all();
+    for (std::thread& thread : pool) {
+        thread.join();
     }
     return distances;
 }
 
-int main() {
+std::vector<Point3D> GenerateBenchmarkPoints(int count, bool on_sphere, std::mt19937_64& generator) {
+    std::uniform_real_distribution<double> coordinate(-1000.0, 1000.0);
+    std::normal_distribution<double> gaussian(0.0, 1.0);
+    std::vector<Point3D> points(count);
+    for (Point3D& p : points) {
+        if (!on_sphere) {
+            p = {coordinate(generator), coordinate(generator), coordinate(generator)};
+            continue;
+        }
+        double length = 0;
+        while (length < kTolerance) {
+            p = {gaussian(generator), gaussian(generator), gaussian(generator)};
+            length = std::sqrt(DotProduct(p, p));
+        }
+        p = {p.x / length * 1000.0, p.y / length * 1000.0, p.z / length * 1000.0};
+    }
+    return points;
+}
+
+void RunHullScalingBenchmark(int max_points) {
+    std::mt19937_64 generator(2024);
+    const unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (int count = 1000000; count <= max_points; count *= 10) {
+        for (const bool on_sphere : {false, true}) {
+            const auto points = GenerateBenchmarkPoints(count, on_sphere, generator);
+            size_t serial_planes = 0;
+            for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+                const auto start = std::chrono::steady_clock::now();
+                const auto planes = ExtractPlanes(BuildConvexHullParallel(points, threads), points);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (threads == 1) serial_planes = planes.size();
+                std::cout << (on_sphere ? "sphere " : "cube ") << count << ", " << threads << " threads: "
+                          << planes.size() << " planes, " << elapsed.count() << " s"
+                          << (planes.size() == serial_planes ? "" : ", MISMATCH") << "\n";
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        RunHullScalingBenchmark(argc > 2 ? std::stoi(argv[2]) : 10000000);
+        return 0;
+    }
+    
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
     int n;
     std::cin >> n;
     const auto points = ReadPoints3D(n);
-    const auto convex_hull = BuildConvexHull(points);
+    const bool parallel = argc > 1 && std::string(argv[1]) == "--parallel";
+    const auto convex_hull = parallel
+        ? BuildConvexHullParallel(points, argc > 2 ? std::stoi(argv[2]) : std::thread::hardware_concurrency())
+        : BuildConvexHull(points);
     const auto planes = ExtractPlanes(convex_hull, points);
     
+    Point3D centroid = {0, 0, 0};
+    for (const Point3D& p : points) {
+        centroid = {centroid.x + p.x / n, centroid.y + p.y / n, centroid.z + p.z / n};
+    }
+    const auto index = BuildPlaneIndex(planes, centroid);
+    
     int q;
     std::cin >> q;
-    const auto distances = CalculateDistances(planes, q);
+    const auto distances = CalculateDistances(index, q, std::thread::hardware_concurrency());
     
     std::cout << std::fixed << std::setprecision(4);
     for (const double distance : distances) {
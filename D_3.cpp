@@ -3,6 +3,7 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <string>
 #include <vector>
 
 struct Point {
@@ -11,6 +12,30 @@ struct Point {
 };
 
 constexpr long double kSnapshotSeconds = 60.0L;
+constexpr std::size_t kBoundLeafEdges = 8;
+
+struct ConvexProfile {
+  std::vector<Point> vertices;
+  std::vector<Point> edges;
+  std::vector<Point> normals;
+  std::vector<long double> offsets;
+};
+
+struct OffsetTree {
+  std::vector<long double> min_offset;
+  std::vector<long double> max_offset;
+};
+
+struct AirportIndex {
+  std::vector<Point> vertices;
+  ConvexProfile profile;
+  OffsetTree offset_tree;
+};
+
+struct DifferenceIndex {
+  ConvexProfile profile;
+  OffsetTree offset_tree;
+};
 
 std::vector<Point> ReadVertices(std::size_t count) {
   std::vector<Point> vertices;
@@ -100,30 +125,337 @@ long double ComputeMinimalTranslationDistance(
   return minimal_distance;
 }
 
-int main() {
+long double Cross(const Point& a, const Point& b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+long double Dot(const Point& a, const Point& b) {
+  return a.x * b.x + a.y * b.y;
+}
+
+// Orders directions by angle in [0, 2*pi), the order in which the edges of a
+// counter-clockwise polygon appear when walked from its lowest vertex.
+bool AngularLess(const Point& a, const Point& b) {
+  bool a_lower = a.y < 0 || (a.y == 0 && a.x < 0);
+  bool b_lower = b.y < 0 || (b.y == 0 && b.x < 0);
+  if (a_lower != b_lower) {
+    return b_lower;
+  }
+  return Cross(a, b) > 0;
+}
+
+ConvexProfile BuildConvexProfile(const std::vector<Point>& polygon) {
+  ConvexProfile profile;
+  std::size_t k = polygon.size();
+  std::size_t start = FindLowestVertexIndex(polygon);
+  for (std::size_t idx = 0; idx < k; ++idx) {
+    const Point& current = polygon[(start + idx) % k];
+    const Point& next = polygon[(start + idx + 1) % k];
+    Point edge = {next.x - current.x, next.y - current.y};
+    long double length = std::hypotl(edge.x, edge.y);
+    Point normal = {0.0L, 0.0L};
+    if (length != 0.0L) {
+      normal = {edge.y / length, -edge.x / length};
+    }
+    profile.vertices.push_back(current);
+    profile.edges.push_back(edge);
+    profile.normals.push_back(normal);
+    profile.offsets.push_back(Dot(normal, current));
+  }
+  return profile;
+}
+
+std::size_t ExtremeVertex(const ConvexProfile& profile,
+                          const Point& direction) {
+  Point tangent = {-direction.y, direction.x};
+  std::size_t idx =
+      std::lower_bound(profile.edges.begin(), profile.edges.end(), tangent,
+                       AngularLess) -
+      profile.edges.begin();
+  return idx == profile.edges.size() ? 0 : idx;
+}
+
+long double LineDistance(const Point& edge, const Point& start) {
+  long double edge_length = std::hypotl(edge.x, edge.y);
+  if (edge_length == 0.0L) {
+    return std::numeric_limits<long double>::infinity();
+  }
+  return std::abs(Cross(edge, start)) / edge_length;
+}
+
+void FillOffsetTree(const std::vector<long double>& offsets, OffsetTree& tree,
+                    std::size_t node, std::size_t lo, std::size_t hi) {
+  if (hi - lo <= kBoundLeafEdges) {
+    auto [min_it, max_it] =
+        std::minmax_element(offsets.begin() + lo, offsets.begin() + hi);
+    tree.min_offset[node] = *min_it;
+    tree.max_offset[node] = *max_it;
+    return;
+  }
+  std::size_t mid = (lo + hi) / 2;
+  FillOffsetTree(offsets, tree, 2 * node, lo, mid);
+  FillOffsetTree(offsets, tree, 2 * node + 1, mid, hi);
+  tree.min_offset[node] =
+      std::min(tree.min_offset[2 * node], tree.min_offset[2 * node + 1]);
+  tree.max_offset[node] =
+      std::max(tree.max_offset[2 * node], tree.max_offset[2 * node + 1]);
+}
+
+OffsetTree BuildOffsetTree(const std::vector<long double>& offsets) {
+  OffsetTree tree;
+  if (!offsets.empty()) {
+    tree.min_offset.assign(4 * offsets.size(), 0.0L);
+    tree.max_offset.assign(4 * offsets.size(), 0.0L);
+    FillOffsetTree(offsets, tree, 1, 0, offsets.size());
+  }
+  return tree;
+}
+
+AirportIndex BuildAirportIndex(const std::vector<Point>& airport) {
+  AirportIndex index;
+  index.vertices = airport;
+  index.profile = BuildConvexProfile(airport);
+  index.offset_tree = BuildOffsetTree(index.profile.offsets);
+  return index;
+}
+
+// Whether some edge normal in [lo, hi) points along `direction`.
+bool NormalArcContains(const ConvexProfile& profile, std::size_t lo,
+                       std::size_t hi, const Point& direction) {
+  Point tangent = {-direction.y, direction.x};
+  return !AngularLess(tangent, profile.edges[lo]) &&
+         !AngularLess(profile.edges[hi - 1], tangent);
+}
+
+// Distance from the origin to the line of the difference edge produced by
+// airport edge `idx` against the matching extreme vertex of the negated cloud.
+long double AirportEdgeDistance(const AirportIndex& airport,
+                                const ConvexProfile& cloud, std::size_t idx) {
+  const Point& edge = airport.profile.edges[idx];
+  const Point& start = airport.profile.vertices[idx];
+  const Point& cloud_vertex =
+      cloud.vertices[ExtremeVertex(cloud, {-edge.y, edge.x})];
+  return LineDistance(edge,
+                      {start.x - cloud_vertex.x, start.y - cloud_vertex.y});
+}
+
+// Lower bound on the signed line offsets of airport edges [lo, hi): the
+// smallest airport offset plus the least support of the negated cloud over
+// the arc of their normals, bounded through one support point of that arc.
+long double AirportRangeBound(const AirportIndex& airport,
+                              const ConvexProfile& cloud, std::size_t node,
+                              std::size_t lo, std::size_t hi) {
+  const ConvexProfile& profile = airport.profile;
+  const Point& middle_edge = profile.edges[(lo + hi) / 2];
+  const Point& cloud_vertex =
+      cloud.vertices[ExtremeVertex(cloud, {-middle_edge.y, middle_edge.x})];
+  Point support = {-cloud_vertex.x, -cloud_vertex.y};
+  long double least_dot;
+  if (NormalArcContains(profile, lo, hi, cloud_vertex)) {
+    least_dot = -std::hypotl(support.x, support.y);
+  } else {
+    least_dot = std::min(Dot(profile.normals[lo], support),
+                         Dot(profile.normals[hi - 1], support));
+  }
+  return airport.offset_tree.min_offset[node] + least_dot;
+}
+
+void SearchAirportEdges(const AirportIndex& airport,
+                        const ConvexProfile& cloud, std::size_t node,
+                        std::size_t lo, std::size_t hi, long double& best) {
+  if (hi - lo <= kBoundLeafEdges) {
+    for (std::size_t idx = lo; idx < hi; ++idx) {
+      best = std::min(best, AirportEdgeDistance(airport, cloud, idx));
+    }
+    return;
+  }
+  std::size_t mid = (lo + hi) / 2;
+  long double left_bound = AirportRangeBound(airport, cloud, 2 * node, lo, mid);
+  long double right_bound =
+      AirportRangeBound(airport, cloud, 2 * node + 1, mid, hi);
+  if (left_bound <= right_bound) {
+    if (left_bound < best) {
+      SearchAirportEdges(airport, cloud, 2 * node, lo, mid, best);
+    }
+    if (right_bound < best) {
+      SearchAirportEdges(airport, cloud, 2 * node + 1, mid, hi, best);
+    }
+  } else {
+    if (right_bound < best) {
+      SearchAirportEdges(airport, cloud, 2 * node + 1, mid, hi, best);
+    }
+    if (left_bound < best) {
+      SearchAirportEdges(airport, cloud, 2 * node, lo, mid, best);
+    }
+  }
+}
+
+long double DistanceToCloud(const AirportIndex& airport,
+                            const std::vector<Point>& cloud) {
+  std::size_t n = airport.vertices.size();
+  std::size_t m = cloud.size();
+  if (n < 3 || m < 3 ||
+      static_cast<long double>(m) * std::log2(static_cast<long double>(n)) >
+          static_cast<long double>(n)) {
+    std::vector<Point> negated_cloud;
+    negated_cloud.reserve(m);
+    for (const Point& pt : cloud) {
+      negated_cloud.push_back({-pt.x, -pt.y});
+    }
+    return ComputeMinimalTranslationDistance(
+        MinkowskiSum(airport.vertices, negated_cloud));
+  }
+
+  ConvexProfile cloud_profile = BuildConvexProfile(cloud);
+  long double best = std::numeric_limits<long double>::infinity();
+  for (std::size_t idx = 0; idx < m; ++idx) {
+    const Point& edge = cloud_profile.edges[idx];
+    const Point& start = cloud_profile.vertices[idx];
+    const Point& airport_vertex =
+        airport.profile.vertices[ExtremeVertex(airport.profile,
+                                               {-edge.y, edge.x})];
+    best = std::min(best, LineDistance({-edge.x, -edge.y},
+                                       {airport_vertex.x - start.x,
+                                        airport_vertex.y - start.y}));
+  }
+  SearchAirportEdges(airport, cloud_profile, 1, 0, n, best);
+  return best;
+}
+
+DifferenceIndex BuildDifferenceIndex(const std::vector<Point>& airport,
+                                     const std::vector<Point>& cloud) {
+  std::vector<Point> negated_cloud;
+  negated_cloud.reserve(cloud.size());
+  for (const Point& pt : cloud) {
+    negated_cloud.push_back({-pt.x, -pt.y});
+  }
+  DifferenceIndex index;
+  index.profile = BuildConvexProfile(MinkowskiSum(airport, negated_cloud));
+  index.offset_tree = BuildOffsetTree(index.profile.offsets);
+  return index;
+}
+
+bool ContainsPoint(const ConvexProfile& profile, const Point& point) {
+  const std::vector<Point>& v = profile.vertices;
+  std::size_t k = v.size();
+  if (k < 3) {
+    return false;
+  }
+  Point relative = {point.x - v[0].x, point.y - v[0].y};
+  if (Cross(profile.edges[0], relative) < 0 ||
+      Cross({v[k - 1].x - v[0].x, v[k - 1].y - v[0].y}, relative) > 0) {
+    return false;
+  }
+  std::size_t low = 1;
+  std::size_t high = k - 1;
+  while (high - low > 1) {
+    std::size_t mid = (low + high) / 2;
+    if (Cross({v[mid].x - v[0].x, v[mid].y - v[0].y}, relative) >= 0) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return Cross({v[high].x - v[low].x, v[high].y - v[low].y},
+               {point.x - v[low].x, point.y - v[low].y}) >= 0;
+}
+
+// Lower bound on |offset - normal . point| over the edges [lo, hi).
+long double DifferenceRangeBound(const DifferenceIndex& index,
+                                 std::size_t node, std::size_t lo,
+                                 std::size_t hi, const Point& point) {
+  const ConvexProfile& profile = index.profile;
+  long double length = std::hypotl(point.x, point.y);
+  long double first_dot = Dot(profile.normals[lo], point);
+  long double last_dot = Dot(profile.normals[hi - 1], point);
+  long double max_dot = NormalArcContains(profile, lo, hi, point)
+                            ? length
+                            : std::max(first_dot, last_dot);
+  long double min_dot = NormalArcContains(profile, lo, hi, {-point.x, -point.y})
+                            ? -length
+                            : std::min(first_dot, last_dot);
+  long double low = index.offset_tree.min_offset[node] - max_dot;
+  long double high = index.offset_tree.max_offset[node] - min_dot;
+  if (low > 0.0L) {
+    return low;
+  }
+  return high < 0.0L ? -high : 0.0L;
+}
+
+void SearchDifferenceEdges(const DifferenceIndex& index, std::size_t node,
+                           std::size_t lo, std::size_t hi, const Point& point,
+                           long double& best) {
+  if (hi - lo <= kBoundLeafEdges) {
+    for (std::size_t idx = lo; idx < hi; ++idx) {
+      const Point& start = index.profile.vertices[idx];
+      best = std::min(best, LineDistance(index.profile.edges[idx],
+                                         {start.x - point.x,
+                                          start.y - point.y}));
+    }
+    return;
+  }
+  std::size_t mid = (lo + hi) / 2;
+  long double left_bound =
+      DifferenceRangeBound(index, 2 * node, lo, mid, point);
+  long double right_bound =
+      DifferenceRangeBound(index, 2 * node + 1, mid, hi, point);
+  if (left_bound <= right_bound) {
+    if (left_bound < best) {
+      SearchDifferenceEdges(index, 2 * node, lo, mid, point, best);
+    }
+    if (right_bound < best) {
+      SearchDifferenceEdges(index, 2 * node + 1, mid, hi, point, best);
+    }
+  } else {
+    if (right_bound < best) {
+      SearchDifferenceEdges(index, 2 * node + 1, mid, hi, point, best);
+    }
+    if (left_bound < best) {
+      SearchDifferenceEdges(index, 2 * node, lo, mid, point, best);
+    }
+  }
+}
+
+// Minimal translation distance once the cloud is moved by `offset`, positive
+// while the moved cloud still overlaps the airport and negative once clear.
+long double SignedDistanceForOffset(const DifferenceIndex& index,
+                                    const Point& offset) {
+  long double best = std::numeric_limits<long double>::infinity();
+  if (!index.profile.edges.empty()) {
+    SearchDifferenceEdges(index, 1, 0, index.profile.edges.size(), offset,
+                          best);
+  }
+  return ContainsPoint(index.profile, offset) ? best : -best;
+}
+
+int main(int argc, char* argv[]) {
   std::ios::sync_with_stdio(false);
   std::cin.tie(nullptr);
 
   std::size_t airport_count, cloud_count;
   std::cin >> airport_count >> cloud_count;
   std::vector<Point> airport_vertices = ReadVertices(airport_count);
-  std::vector<Point> cloud_vertices = ReadVertices(cloud_count);
 
-  std::vector<Point> negated_cloud;
-  negated_cloud.reserve(cloud_count);
-  for (const Point& pt : cloud_vertices) {
-    negated_cloud.push_back({-pt.x, -pt.y});
-  }
-
-  std::vector<Point> minkowski_diff =
-      MinkowskiSum(airport_vertices, negated_cloud);
-  long double minimal_shift =
-      ComputeMinimalTranslationDistance(minkowski_diff);
-  long double remaining_time = minimal_shift - kSnapshotSeconds;
-  if (remaining_time < 0.0L) {
-    remaining_time = 0.0L;
+  std::cout << std::fixed << std::setprecision(9);
+  if (argc > 1 && std::string(argv[1]) == "--offsets") {
+    DifferenceIndex difference =
+        BuildDifferenceIndex(airport_vertices, ReadVertices(cloud_count));
+    long double dx, dy;
+    while (std::cin >> dx >> dy) {
+      std::cout << SignedDistanceForOffset(difference, {dx, dy}) << "\n";
+    }
+    return 0;
   }
 
-  std::cout << std::fixed << std::setprecision(9) << remaining_time << "\n";
+  AirportIndex airport = BuildAirportIndex(airport_vertices);
+  do {
+    std::vector<Point> cloud_vertices = ReadVertices(cloud_count);
+    long double minimal_shift = DistanceToCloud(airport, cloud_vertices);
+    long double remaining_time = minimal_shift - kSnapshotSeconds;
+    if (remaining_time < 0.0L) {
+      remaining_time = 0.0L;
+    }
+    std::cout << remaining_time << "\n";
+  } while (std::cin >> cloud_count);
   return 0;
 }
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <string>
+#include <functional>
 
 struct Point {
     long double x;
@@ -82,33 +84,394 @@ static Polygon ClipPolygon(const Polygon& polygon,
     return clipped_polygon;
 }
 
-static Polygon ComputeZoneForPlayer(int player_index, const std::vector<Point>& all_players) {
+static Polygon FieldRectangle() {
     Polygon zone;
     zone.vertices.reserve(4);
     zone.vertices.push_back({0.0L, 0.0L});
     zone.vertices.push_back({global_field_width, 0.0L});
     zone.vertices.push_back({global_field_width, global_field_height});
     zone.vertices.push_back({0.0L, global_field_height});
+    return zone;
+}
+
+// Keeps the part of zone that is at least as close to current_player as to other_player.
+static Polygon ClipByBisector(const Polygon& zone, const Point& current_player, const Point& other_player) {
+    long double line_a = other_player.x - current_player.x;
+    long double line_b = other_player.y - current_player.y;
+    long double line_c = (other_player.x * other_player.x - current_player.x * current_player.x +
+                         other_player.y * other_player.y - current_player.y * current_player.y) * 0.5L;
+    return ClipPolygon(zone, line_a, line_b, line_c);
+}
 
-    long double current_player_x = all_players[player_index].x;
-    long double current_player_y = all_players[player_index].y;
+// Players bucketed into square cells over their bounding box; the players
+// of cell c are cell_players[cell_start[c] .. cell_start[c + 1]).
+struct PlayerGrid {
+    long double min_x;
+    long double min_y;
+    long double cell_size;
+    int columns;
+    int rows;
+    std::vector<int> cell_start;
+    std::vector<int> cell_players;
+};
 
-    for (size_t other_player_index = 0; other_player_index < all_players.size(); ++other_player_index) {
-        if (static_cast<int>(other_player_index) == player_index) continue;
-        long double other_player_x = all_players[other_player_index].x;
-        long double other_player_y = all_players[other_player_index].y;
+static int GridColumnOf(const PlayerGrid& grid, const Point& player) {
+    return std::min(grid.columns - 1, static_cast<int>((player.x - grid.min_x) / grid.cell_size));
+}
+
+static int GridRowOf(const PlayerGrid& grid, const Point& player) {
+    return std::min(grid.rows - 1, static_cast<int>((player.y - grid.min_y) / grid.cell_size));
+}
+
+// About one player per cell; collinear players fall back to cells along
+// the longer side.
+static PlayerGrid BuildPlayerGrid(const std::vector<Point>& all_players) {
+    PlayerGrid grid;
+    const int num_players = all_players.size();
+    if (num_players == 0) {
+        grid.min_x = grid.min_y = 0.0L;
+        grid.cell_size = 1.0L;
+        grid.columns = grid.rows = 1;
+        grid.cell_start.assign(2, 0);
+        return grid;
+    }
+    grid.min_x = grid.min_y = std::numeric_limits<long double>::max();
+    long double max_x = std::numeric_limits<long double>::lowest();
+    long double max_y = std::numeric_limits<long double>::lowest();
+    for (const Point& player : all_players) {
+        grid.min_x = std::min(grid.min_x, player.x);
+        grid.min_y = std::min(grid.min_y, player.y);
+        max_x = std::max(max_x, player.x);
+        max_y = std::max(max_y, player.y);
+    }
+    const long double width = max_x - grid.min_x;
+    const long double height = max_y - grid.min_y;
+    grid.cell_size = std::max(sqrtl(width * height / num_players), std::max(width, height) / num_players);
+    if (grid.cell_size <= kEpsilon) grid.cell_size = 1.0L;
+    grid.columns = static_cast<int>(width / grid.cell_size) + 1;
+    grid.rows = static_cast<int>(height / grid.cell_size) + 1;
 
-        long double line_a = other_player_x - current_player_x;
-        long double line_b = other_player_y - current_player_y;
-        long double line_c = (other_player_x * other_player_x - current_player_x * current_player_x +
-                             other_player_y * other_player_y - current_player_y * current_player_y) * 0.5L;
+    std::vector<int> cell_of(num_players);
+    grid.cell_start.assign(static_cast<size_t>(grid.columns) * grid.rows + 1, 0);
+    for (int i = 0; i < num_players; ++i) {
+        cell_of[i] = GridRowOf(grid, all_players[i]) * grid.columns + GridColumnOf(grid, all_players[i]);
+        ++grid.cell_start[cell_of[i] + 1];
+    }
+    for (size_t c = 1; c < grid.cell_start.size(); ++c) {
+        grid.cell_start[c] += grid.cell_start[c - 1];
+    }
+    grid.cell_players.resize(num_players);
+    std::vector<int> fill(grid.cell_start.begin(), grid.cell_start.end() - 1);
+    for (int i = 0; i < num_players; ++i) {
+        grid.cell_players[fill[cell_of[i]]++] = i;
+    }
+    return grid;
+}
+
+// Clips against the other players in increasing distance, visiting the
+// grid ring by ring. A player farther than twice the zone's largest vertex
+// distance has its bisector beyond every vertex, so it and all later
+// players leave the zone unchanged and the loop stops. The different clip
+// order can flip the last printed digit of a coordinate on a rounding tie.
+static Polygon ComputeZoneForPlayer(int player_index, const std::vector<Point>& all_players,
+                                    const PlayerGrid& grid) {
+    Polygon zone = FieldRectangle();
+    const Point& current_player = all_players[player_index];
+    const int column = GridColumnOf(grid, current_player);
+    const int row = GridRowOf(grid, current_player);
+    const int last_ring = std::max(grid.columns, grid.rows);
+
+    auto squared_distance = [&](const Point& point) {
+        const long double dx = point.x - current_player.x;
+        const long double dy = point.y - current_player.y;
+        return dx * dx + dy * dy;
+    };
+    auto farthest_vertex = [&] {
+        long double farthest = 0.0L;
+        for (const Point& vertex : zone.vertices) farthest = std::max(farthest, squared_distance(vertex));
+        return farthest;
+    };
+
+    std::vector<std::pair<long double, int>> candidates;
+    auto visit_ring = [&](int ring) {
+        for (int r = std::max(row - ring, 0); r <= std::min(row + ring, grid.rows - 1); ++r) {
+            const bool full_row = r == row - ring || r == row + ring;
+            const int step = full_row ? 1 : 2 * ring;
+            for (int c = column - ring; c <= column + ring; c += std::max(step, 1)) {
+                if (c < 0 || c >= grid.columns) continue;
+                const int cell = r * grid.columns + c;
+                for (int k = grid.cell_start[cell]; k < grid.cell_start[cell + 1]; ++k) {
+                    const int other = grid.cell_players[k];
+                    if (other == player_index) continue;
+                    candidates.push_back({squared_distance(all_players[other]), other});
+                    std::push_heap(candidates.begin(), candidates.end(), std::greater<>());
+                }
+            }
+        }
+    };
 
-        zone = ClipPolygon(zone, line_a, line_b, line_c);
+    long double stop_distance = 4.0L * farthest_vertex();
+    int ring = 0;
+    visit_ring(ring);
+    while (true) {
+        const long double unvisited = ring >= last_ring ? std::numeric_limits<long double>::max()
+                                                        : ring * grid.cell_size * ring * grid.cell_size;
+        if (candidates.empty() || candidates.front().first > unvisited) {
+            if (unvisited > stop_distance) break;
+            visit_ring(++ring);
+            continue;
+        }
+        std::pop_heap(candidates.begin(), candidates.end(), std::greater<>());
+        const auto [distance, other] = candidates.back();
+        candidates.pop_back();
+        if (distance > stop_distance) break;
+        zone = ClipByBisector(zone, current_player, all_players[other]);
         if (zone.vertices.empty()) break;
+        stop_distance = 4.0L * farthest_vertex();
     }
     return zone;
 }
 
+// Quad-edge structure for the Guibas-Stolfi Delaunay triangulation. Each
+// edge record owns four directed edges 4k..4k+3, each the rotation of the
+// previous one; 4k and 4k+2 are the primal edge and its reverse, the odd
+// ones belong to the dual and carry no origin.
+struct QuadEdgeMesh {
+    std::vector<int> origin;
+    std::vector<int> onext;
+    std::vector<bool> deleted;
+    const std::vector<Point>* sites;
+};
+
+static int RotEdge(int e) { return (e & ~3) | ((e + 1) & 3); }
+static int ReverseEdge(int e) { return e ^ 2; }
+static int InverseRotEdge(int e) { return (e & ~3) | ((e + 3) & 3); }
+
+static int OprevEdge(const QuadEdgeMesh& mesh, int e) { return RotEdge(mesh.onext[RotEdge(e)]); }
+static int LnextEdge(const QuadEdgeMesh& mesh, int e) { return RotEdge(mesh.onext[InverseRotEdge(e)]); }
+static int DestOf(const QuadEdgeMesh& mesh, int e) { return mesh.origin[ReverseEdge(e)]; }
+
+static int MakeEdge(QuadEdgeMesh& mesh, int from, int to) {
+    const int base = mesh.origin.size();
+    mesh.origin.insert(mesh.origin.end(), {from, -1, to, -1});
+    mesh.onext.insert(mesh.onext.end(), {base, base + 3, base + 2, base + 1});
+    mesh.deleted.push_back(false);
+    return base;
+}
+
+static void Splice(QuadEdgeMesh& mesh, int a, int b) {
+    const int alpha = RotEdge(mesh.onext[a]);
+    const int beta = RotEdge(mesh.onext[b]);
+    std::swap(mesh.onext[alpha], mesh.onext[beta]);
+    std::swap(mesh.onext[a], mesh.onext[b]);
+}
+
+static void DeleteEdge(QuadEdgeMesh& mesh, int e) {
+    Splice(mesh, e, OprevEdge(mesh, e));
+    Splice(mesh, ReverseEdge(e), OprevEdge(mesh, ReverseEdge(e)));
+    mesh.deleted[e >> 2] = true;
+}
+
+static int ConnectEdges(QuadEdgeMesh& mesh, int a, int b) {
+    const int e = MakeEdge(mesh, DestOf(mesh, a), mesh.origin[b]);
+    Splice(mesh, e, LnextEdge(mesh, a));
+    Splice(mesh, ReverseEdge(e), b);
+    return e;
+}
+
+// Predicates are evaluated in long double and, when the value is within
+// the rounding error bound of zero, again in __float128; only a value that
+// is still undecided counts as a tie. A plain epsilon test is not enough:
+// nearly collinear or cocircular sites then get contradictory answers from
+// different argument orders and the merge loses edges.
+static const long double kLongDoubleErrorBound = 1e-17L;
+static const __float128 kQuadErrorBound = 1e-31L;
+
+template <typename Real>
+static Real AbsoluteValue(Real value) {
+    return value < 0 ? -value : value;
+}
+
+template <typename Real>
+static int TurnSignIn(const Point& p, const Point& a, const Point& b, Real error_bound) {
+    const Real lhs = (Real(a.x) - Real(p.x)) * (Real(b.y) - Real(p.y));
+    const Real rhs = (Real(a.y) - Real(p.y)) * (Real(b.x) - Real(p.x));
+    const Real margin = error_bound * (AbsoluteValue(lhs) + AbsoluteValue(rhs));
+    if (lhs - rhs > margin) return 1;
+    if (rhs - lhs > margin) return -1;
+    return 0;
+}
+
+static int TurnSign(const Point& p, const Point& a, const Point& b) {
+    const int sign = TurnSignIn<long double>(p, a, b, kLongDoubleErrorBound);
+    return sign != 0 ? sign : TurnSignIn<__float128>(p, a, b, kQuadErrorBound);
+}
+
+template <typename Real>
+static int InCircleSignIn(const Point& a, const Point& b, const Point& c, const Point& d, Real error_bound) {
+    const Real adx = Real(a.x) - Real(d.x), ady = Real(a.y) - Real(d.y);
+    const Real bdx = Real(b.x) - Real(d.x), bdy = Real(b.y) - Real(d.y);
+    const Real cdx = Real(c.x) - Real(d.x), cdy = Real(c.y) - Real(d.y);
+    const Real a_lift = adx * adx + ady * ady;
+    const Real b_lift = bdx * bdx + bdy * bdy;
+    const Real c_lift = cdx * cdx + cdy * cdy;
+    const Real determinant = a_lift * (bdx * cdy - cdx * bdy) -
+                             b_lift * (adx * cdy - cdx * ady) +
+                             c_lift * (adx * bdy - bdx * ady);
+    const Real permanent = a_lift * (AbsoluteValue(bdx * cdy) + AbsoluteValue(cdx * bdy)) +
+                           b_lift * (AbsoluteValue(adx * cdy) + AbsoluteValue(cdx * ady)) +
+                           c_lift * (AbsoluteValue(adx * bdy) + AbsoluteValue(bdx * ady));
+    const Real margin = error_bound * permanent;
+    if (determinant > margin) return 1;
+    if (determinant < -margin) return -1;
+    return 0;
+}
+
+static bool IsLeftOf(const QuadEdgeMesh& mesh, int site, int e) {
+    const std::vector<Point>& sites = *mesh.sites;
+    return TurnSign(sites[site], sites[mesh.origin[e]], sites[DestOf(mesh, e)]) > 0;
+}
+
+static bool IsRightOf(const QuadEdgeMesh& mesh, int site, int e) {
+    const std::vector<Point>& sites = *mesh.sites;
+    return TurnSign(sites[site], sites[mesh.origin[e]], sites[DestOf(mesh, e)]) < 0;
+}
+
+// True when d lies strictly inside the circle through the counter-clockwise a, b, c.
+static bool IsInCircle(const QuadEdgeMesh& mesh, int a, int b, int c, int d) {
+    const std::vector<Point>& sites = *mesh.sites;
+    int sign = InCircleSignIn<long double>(sites[a], sites[b], sites[c], sites[d], kLongDoubleErrorBound);
+    if (sign == 0) sign = InCircleSignIn<__float128>(sites[a], sites[b], sites[c], sites[d], kQuadErrorBound);
+    return sign > 0;
+}
+
+// Triangulates the lexicographically sorted, distinct sites [first, last]
+// and returns the counter-clockwise hull edge leaving the leftmost site and
+// the clockwise hull edge leaving the rightmost one.
+static std::pair<int, int> TriangulateRange(QuadEdgeMesh& mesh, int first, int last) {
+    if (last - first == 1) {
+        const int e = MakeEdge(mesh, first, last);
+        return {e, ReverseEdge(e)};
+    }
+    if (last - first == 2) {
+        const int a = MakeEdge(mesh, first, first + 1);
+        const int b = MakeEdge(mesh, first + 1, last);
+        Splice(mesh, ReverseEdge(a), b);
+        const std::vector<Point>& sites = *mesh.sites;
+        const int turn = TurnSign(sites[first], sites[first + 1], sites[last]);
+        if (turn == 0) return {a, ReverseEdge(b)};
+        const int c = ConnectEdges(mesh, b, a);
+        if (turn > 0) return {a, ReverseEdge(b)};
+        return {ReverseEdge(c), c};
+    }
+
+    const int middle = (first + last) / 2;
+    auto [left_outer, left_inner] = TriangulateRange(mesh, first, middle);
+    auto [right_inner, right_outer] = TriangulateRange(mesh, middle + 1, last);
+    while (true) {
+        if (IsLeftOf(mesh, mesh.origin[right_inner], left_inner)) {
+            left_inner = LnextEdge(mesh, left_inner);
+        } else if (IsRightOf(mesh, mesh.origin[left_inner], right_inner)) {
+            right_inner = mesh.onext[ReverseEdge(right_inner)];
+        } else {
+            break;
+        }
+    }
+
+    int base = ConnectEdges(mesh, ReverseEdge(right_inner), left_inner);
+    if (mesh.origin[left_inner] == mesh.origin[left_outer]) left_outer = ReverseEdge(base);
+    if (mesh.origin[right_inner] == mesh.origin[right_outer]) right_outer = base;
+    auto is_valid = [&](int e) { return IsRightOf(mesh, DestOf(mesh, e), base); };
+
+    while (true) {
+        int left_candidate = mesh.onext[ReverseEdge(base)];
+        if (is_valid(left_candidate)) {
+            while (IsInCircle(mesh, DestOf(mesh, base), mesh.origin[base], DestOf(mesh, left_candidate),
+                              DestOf(mesh, mesh.onext[left_candidate]))) {
+                const int next = mesh.onext[left_candidate];
+                DeleteEdge(mesh, left_candidate);
+                left_candidate = next;
+            }
+        }
+        int right_candidate = OprevEdge(mesh, base);
+        if (is_valid(right_candidate)) {
+            while (IsInCircle(mesh, DestOf(mesh, base), mesh.origin[base], DestOf(mesh, right_candidate),
+                              DestOf(mesh, OprevEdge(mesh, right_candidate)))) {
+                const int next = OprevEdge(mesh, right_candidate);
+                DeleteEdge(mesh, right_candidate);
+                right_candidate = next;
+            }
+        }
+        const bool left_valid = is_valid(left_candidate);
+        const bool right_valid = is_valid(right_candidate);
+        if (!left_valid && !right_valid) break;
+        if (!left_valid ||
+            (right_valid && IsInCircle(mesh, DestOf(mesh, left_candidate), mesh.origin[left_candidate],
+                                       mesh.origin[right_candidate], DestOf(mesh, right_candidate)))) {
+            base = ConnectEdges(mesh, right_candidate, ReverseEdge(base));
+        } else {
+            base = ConnectEdges(mesh, ReverseEdge(base), ReverseEdge(left_candidate));
+        }
+    }
+    return {left_outer, right_outer};
+}
+
+// Voronoi zones as the dual of the Delaunay triangulation: a zone is the
+// field clipped only by the bisectors towards its Delaunay neighbours,
+// which bound it exactly. Players sharing a position share a zone.
+// Clipping by fewer bisectors can move a vertex by an ulp, so a printed
+// coordinate sitting exactly on a rounding tie may differ in its last
+// digit from clipping by every player.
+static std::vector<Polygon> ComputeVoronoiZones(const std::vector<Point>& all_players) {
+    const int num_players = all_players.size();
+    std::vector<int> order(num_players);
+    for (int i = 0; i < num_players; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+        if (all_players[lhs].x != all_players[rhs].x) return all_players[lhs].x < all_players[rhs].x;
+        return all_players[lhs].y < all_players[rhs].y;
+    });
+
+    std::vector<Point> sites;
+    std::vector<int> site_of(num_players);
+    for (const int player : order) {
+        if (sites.empty() || sites.back().x != all_players[player].x || sites.back().y != all_players[player].y) {
+            sites.push_back(all_players[player]);
+        }
+        site_of[player] = static_cast<int>(sites.size()) - 1;
+    }
+
+    QuadEdgeMesh mesh;
+    mesh.sites = &sites;
+    mesh.origin.reserve(sites.size() * 16);
+    mesh.onext.reserve(sites.size() * 16);
+    if (sites.size() > 1) TriangulateRange(mesh, 0, static_cast<int>(sites.size()) - 1);
+
+    std::vector<std::vector<int>> neighbours(sites.size());
+    for (size_t record = 0; record < mesh.deleted.size(); ++record) {
+        if (mesh.deleted[record]) continue;
+        const int u = mesh.origin[4 * record];
+        const int v = mesh.origin[4 * record + 2];
+        neighbours[u].push_back(v);
+        neighbours[v].push_back(u);
+    }
+
+    std::vector<Polygon> site_zones(sites.size());
+    for (size_t site = 0; site < sites.size(); ++site) {
+        Polygon& zone = site_zones[site];
+        zone = FieldRectangle();
+        for (const int other : neighbours[site]) {
+            zone = ClipByBisector(zone, sites[site], sites[other]);
+            if (zone.vertices.empty()) break;
+        }
+    }
+
+    std::vector<Polygon> zones(num_players);
+    for (int i = 0; i < num_players; ++i) {
+        zones[i] = site_zones[site_of[i]];
+    }
+    return zones;
+}
+
 static void PreparePolygonOutput(Polygon& polygon) {
     if (polygon.vertices.empty()) return;
 
@@ -165,18 +528,24 @@ static void OutputZones(const std::vector<Polygon>& zones) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
     std::vector<Point> players;
     ReadInput(players);
     std::vector<Polygon> zones;
-    zones.reserve(players.size());
-    for (int i = 0; i < static_cast<int>(players.size()); ++i) {
-        Polygon zone = ComputeZoneForPlayer(i, players);
+    if (argc > 1 && std::string(argv[1]) == "--clip-nearest") {
+        const PlayerGrid grid = BuildPlayerGrid(players);
+        zones.reserve(players.size());
+        for (int i = 0; i < static_cast<int>(players.size()); ++i) {
+            zones.push_back(ComputeZoneForPlayer(i, players, grid));
+        }
+    } else {
+        zones = ComputeVoronoiZones(players);
+    }
+    for (Polygon& zone : zones) {
         PreparePolygonOutput(zone);
-        zones.push_back(zone);
     }
     OutputZones(zones);
     return 0;
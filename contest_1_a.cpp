@@ -1,8 +1,41 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+constexpr std::size_t kStreamChunkSize = 1 << 20;
+constexpr std::size_t kPrefilterSampleSize = 4096;
+constexpr double kPrefilterMaxDensity = 1.0 / 16;
+constexpr std::size_t kParallelMinChunk = 1 << 22;
+constexpr std::size_t kDfaMaxTableBytes = 1 << 18;
+
+template <typename It>
+concept ContiguousCharIterator =
+    std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, char>;
+
 template <typename ForwardIt>
 std::vector<int> calculatePrefixFunction(ForwardIt first, ForwardIt last) {
     using Index = typename std::iterator_traits<ForwardIt>::difference_type;
@@ -21,6 +54,421 @@ std::vector<int> calculatePrefixFunction(ForwardIt first, ForwardIt last) {
     return prefix;
 }
 
+class RareBytePrefilter {
+public:
+    RareBytePrefilter(const char* pattern, std::size_t m,
+                      const char* sample, std::size_t sample_length) {
+        std::array<std::size_t, 256> frequency{};
+        const std::size_t step = std::max<std::size_t>(1, sample_length / kPrefilterSampleSize);
+        std::size_t sampled = 0;
+        for (std::size_t i = 0; i < sample_length; i += step, ++sampled) {
+            ++frequency[static_cast<unsigned char>(sample[i])];
+        }
+        auto rarity = [&](std::size_t j) {
+            return frequency[static_cast<unsigned char>(pattern[j])];
+        };
+
+        for (std::size_t j = 1; j < m; ++j) {
+            if (rarity(j) < rarity(first_offset)) {
+                first_offset = j;
+            }
+        }
+        second_offset = first_offset;
+        for (std::size_t j = 0; j < m; ++j) {
+            if (pattern[j] == pattern[first_offset]) {
+                continue;
+            }
+            if (second_offset == first_offset || rarity(j) < rarity(second_offset)) {
+                second_offset = j;
+            }
+        }
+        first_byte = pattern[first_offset];
+        second_byte = pattern[second_offset];
+
+        double density = (rarity(first_offset) + 1.0) / (sampled + 1.0);
+        if (second_offset != first_offset) {
+            density *= (rarity(second_offset) + 1.0) / (sampled + 1.0);
+        }
+        useful = density <= kPrefilterMaxDensity;
+    }
+
+    bool enabled() const { return useful; }
+
+    std::size_t next(const char* text, std::size_t from, std::size_t last_start) const {
+        if (from > last_start) {
+            return from;
+        }
+#ifdef HAVE_X86_SIMD
+        if (__builtin_cpu_supports("avx2")) {
+            return nextAvx2(text, from, last_start);
+        }
+#endif
+        for (std::size_t s = from; s <= last_start; ++s) {
+            const void* hit = std::memchr(text + s + first_offset, first_byte, last_start + 1 - s);
+            if (hit == nullptr) {
+                break;
+            }
+            s = static_cast<const char*>(hit) - text - first_offset;
+            if (text[s + second_offset] == second_byte) {
+                return s;
+            }
+        }
+        return last_start + 1;
+    }
+
+private:
+#ifdef HAVE_X86_SIMD
+    __attribute__((target("avx2")))
+    std::size_t nextAvx2(const char* text, std::size_t from, std::size_t last_start) const {
+        const __m256i first_mask = _mm256_set1_epi8(first_byte);
+        const __m256i second_mask = _mm256_set1_epi8(second_byte);
+        std::size_t s = from;
+        for (; s + 32 <= last_start + 1; s += 32) {
+            const __m256i first_block = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(text + s + first_offset));
+            const __m256i second_block = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(text + s + second_offset));
+            const unsigned hits = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first_block, first_mask),
+                                 _mm256_cmpeq_epi8(second_block, second_mask))));
+            if (hits != 0) {
+                return s + __builtin_ctz(hits);
+            }
+        }
+        for (; s <= last_start; ++s) {
+            if (text[s + first_offset] == first_byte && text[s + second_offset] == second_byte) {
+                return s;
+            }
+        }
+        return last_start + 1;
+    }
+#endif
+
+    std::size_t first_offset = 0;
+    std::size_t second_offset = 0;
+    char first_byte = 0;
+    char second_byte = 0;
+    bool useful = false;
+};
+
+template <typename Callback, typename Position>
+bool reportOccurrence(Callback& callback, Position position) {
+    if constexpr (std::is_void_v<std::invoke_result_t<Callback&, Position>>) {
+        callback(position);
+        return true;
+    } else {
+        return static_cast<bool>(callback(position));
+    }
+}
+
+class StreamingPatternMatcher {
+public:
+    explicit StreamingPatternMatcher(const std::string& pattern)
+        : pattern(pattern),
+          prefix(calculatePrefixFunction(pattern.begin(), pattern.end())) {
+        buildAutomaton();
+    }
+
+    template <typename OnMatch>
+    bool feed(const char* first, const char* last, OnMatch onMatch) {
+        if (!prefilter) {
+            prefilter.emplace(pattern.data(), pattern.size(), first, last - first);
+        }
+        if (transitions.empty()) {
+            const std::size_t m = pattern.size();
+            return scan(first, last, onMatch, m, prefix[m - 1], [this](std::size_t state, char c) {
+                while (state > 0 && pattern[state] != c) {
+                    state = prefix[state - 1];
+                }
+                return pattern[state] == c ? state + 1 : state;
+            });
+        } else {
+            const std::size_t accept = pattern.size() * class_count;
+            return scan(first, last, onMatch, accept, accept, [this](std::size_t row, char c) {
+                return static_cast<std::size_t>(
+                    transitions[row + byte_class[static_cast<unsigned char>(c)]]);
+            });
+        }
+    }
+
+private:
+    void buildAutomaton() {
+        const std::size_t m = pattern.size();
+        byte_class.fill(0);
+        class_count = 1;
+        for (char c : pattern) {
+            std::uint16_t& cls = byte_class[static_cast<unsigned char>(c)];
+            if (cls == 0) {
+                cls = static_cast<std::uint16_t>(class_count++);
+            }
+        }
+        if ((m + 1) * class_count * sizeof(std::uint32_t) > kDfaMaxTableBytes) {
+            return;
+        }
+
+        std::vector<char> representative(class_count, 0);
+        for (char c : pattern) {
+            representative[byte_class[static_cast<unsigned char>(c)]] = c;
+        }
+        transitions.assign((m + 1) * class_count, 0);
+        for (std::size_t state = 0; state <= m; ++state) {
+            for (std::size_t cls = 0; cls < class_count; ++cls) {
+                std::uint32_t next = 0;
+                if (state < m && cls != 0 && pattern[state] == representative[cls]) {
+                    next = static_cast<std::uint32_t>((state + 1) * class_count);
+                } else if (state > 0) {
+                    next = transitions[prefix[state - 1] * class_count + cls];
+                }
+                transitions[state * class_count + cls] = next;
+            }
+        }
+    }
+
+    template <typename OnMatch, typename Step>
+    bool scan(const char* first, const char* last, OnMatch& onMatch,
+              std::size_t accept, std::size_t after_match, Step step) {
+        const std::size_t m = pattern.size();
+        const std::size_t length = last - first;
+        const bool skipping = prefilter->enabled() && length >= m;
+
+        for (std::size_t i = 0; i < length; ++i) {
+            if (matched == 0 && skipping) {
+                i = prefilter->next(first, i, length - m);
+                if (i == length) {
+                    break;
+                }
+            }
+            matched = step(matched, first[i]);
+            if (matched == accept) {
+                matched = after_match;
+                const long long position =
+                    consumed + static_cast<long long>(i) - static_cast<long long>(m) + 1;
+                if (!reportOccurrence(onMatch, position)) {
+                    consumed += static_cast<long long>(i + 1);
+                    return false;
+                }
+            }
+        }
+        consumed += static_cast<long long>(length);
+        return true;
+    }
+
+    std::string pattern;
+    std::vector<int> prefix;
+    std::array<std::uint16_t, 256> byte_class;
+    std::size_t class_count = 0;
+    std::vector<std::uint32_t> transitions;
+    std::optional<RareBytePrefilter> prefilter;
+    std::size_t matched = 0;  // row offset into transitions when the DFA is in use
+    long long consumed = 0;
+};
+
+template <typename Index>
+std::vector<Index> findContiguousOccurrences(const std::string& pattern,
+                                             const char* text, std::size_t n) {
+    const std::size_t m = pattern.size();
+    const std::size_t threads = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), n / kParallelMinChunk);
+    if (threads <= 1) {
+        std::vector<Index> occurrences;
+        StreamingPatternMatcher matcher(pattern);
+        matcher.feed(text, text + n, [&](long long position) {
+            occurrences.push_back(static_cast<Index>(position));
+        });
+        return occurrences;
+    }
+
+    const std::size_t chunk = (n + threads - 1) / threads;
+    std::vector<std::vector<Index>> partial(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        const std::size_t begin = std::min(n, t * chunk);
+        const std::size_t end = std::min(n, begin + chunk + m - 1);
+        workers.emplace_back([&pattern, &partial, text, t, begin, end] {
+            StreamingPatternMatcher matcher(pattern);
+            matcher.feed(text + begin, text + end, [&](long long position) {
+                partial[t].push_back(static_cast<Index>(begin + position));
+            });
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::size_t total = 0;
+    for (const auto& occurrences : partial) {
+        total += occurrences.size();
+    }
+    std::vector<Index> occurrences;
+    occurrences.reserve(total);
+    for (const auto& part : partial) {
+        occurrences.insert(occurrences.end(), part.begin(), part.end());
+    }
+    return occurrences;
+}
+
+inline std::size_t countContiguousOccurrences(const std::string& pattern,
+                                              const char* text, std::size_t n) {
+    const std::size_t m = pattern.size();
+    const std::size_t threads = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), n / kParallelMinChunk);
+    if (threads <= 1) {
+        std::size_t count = 0;
+        StreamingPatternMatcher matcher(pattern);
+        matcher.feed(text, text + n, [&count](long long) { ++count; });
+        return count;
+    }
+
+    const std::size_t chunk = (n + threads - 1) / threads;
+    std::vector<std::size_t> partial(threads, 0);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        const std::size_t begin = std::min(n, t * chunk);
+        const std::size_t end = std::min(n, begin + chunk + m - 1);
+        workers.emplace_back([&pattern, &partial, text, t, begin, end] {
+            StreamingPatternMatcher matcher(pattern);
+            matcher.feed(text + begin, text + end, [&](long long) { ++partial[t]; });
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::size_t count = 0;
+    for (std::size_t part : partial) {
+        count += part;
+    }
+    return count;
+}
+
+template <typename PatternIt, typename TextIt>
+class PatternOccurrenceRange {
+public:
+    using Index = typename std::iterator_traits<TextIt>::difference_type;
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Index;
+        using difference_type = std::ptrdiff_t;
+        using reference = Index;
+
+        iterator() = default;
+        explicit iterator(PatternOccurrenceRange* range) : range(range) { advance(); }
+
+        Index operator*() const { return current; }
+
+        iterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        void operator++(int) { advance(); }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.range == nullptr;
+        }
+
+    private:
+        void advance() {
+            if (!range->next(current)) {
+                range = nullptr;
+            }
+        }
+
+        PatternOccurrenceRange* range = nullptr;
+        Index current = 0;
+    };
+
+    PatternOccurrenceRange(PatternIt pat_first, PatternIt pat_last,
+                           TextIt text_first, TextIt text_last)
+        : pat_first(pat_first),
+          text_first(text_first),
+          m(std::distance(pat_first, pat_last)),
+          n(std::distance(text_first, text_last)),
+          prefix(calculatePrefixFunction(pat_first, pat_last)) {}
+
+    iterator begin() { return iterator(this); }
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    bool next(Index& occurrence) {
+        if (m == 0) {
+            return false;
+        }
+        while (position < n) {
+            const auto c = *(text_first + position);
+            while (matched > 0 && *(pat_first + matched) != c) {
+                matched = prefix[matched - 1];
+            }
+            if (*(pat_first + matched) == c) {
+                ++matched;
+            }
+            ++position;
+            if (matched == m) {
+                occurrence = position - m;
+                matched = prefix[matched - 1];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    PatternIt pat_first;
+    TextIt text_first;
+    Index m;
+    Index n;
+    std::vector<int> prefix;
+    Index matched = 0;
+    Index position = 0;
+};
+
+template <typename PatternIt, typename TextIt>
+PatternOccurrenceRange<PatternIt, TextIt> patternOccurrences(PatternIt pat_first, PatternIt pat_last,
+                                                             TextIt text_first, TextIt text_last) {
+    return {pat_first, pat_last, text_first, text_last};
+}
+
+inline PatternOccurrenceRange<std::string::const_iterator, std::string::const_iterator>
+patternOccurrences(const std::string& pattern, const std::string& text) {
+    return {pattern.begin(), pattern.end(), text.begin(), text.end()};
+}
+
+template <typename PatternIt, typename TextIt, typename Callback>
+void forEachPatternOccurrence(PatternIt pat_first, PatternIt pat_last,
+                              TextIt text_first, TextIt text_last, Callback callback) {
+    using Index = typename std::iterator_traits<TextIt>::difference_type;
+    if (pat_first == pat_last) return;
+
+    if constexpr (ContiguousCharIterator<PatternIt> && ContiguousCharIterator<TextIt>) {
+        StreamingPatternMatcher matcher(std::string(pat_first, pat_last));
+        const char* text = std::to_address(text_first);
+        matcher.feed(text, text + std::distance(text_first, text_last), [&](long long position) {
+            return reportOccurrence(callback, static_cast<Index>(position));
+        });
+    } else {
+        for (Index position : patternOccurrences(pat_first, pat_last, text_first, text_last)) {
+            if (!reportOccurrence(callback, position)) {
+                break;
+            }
+        }
+    }
+}
+
+template <typename Callback>
+void forEachPatternOccurrence(const std::string& pattern, const std::string& text,
+                              Callback callback) {
+    forEachPatternOccurrence(pattern.begin(), pattern.end(), text.begin(), text.end(),
+                             std::move(callback));
+}
+
+inline std::size_t countPatternOccurrences(const std::string& pattern, const std::string& text) {
+    if (pattern.empty()) return 0;
+    return countContiguousOccurrences(pattern, text.data(), text.size());
+}
+
 template <typename PatternIt, typename TextIt>
 std::vector<typename std::iterator_traits<TextIt>::difference_type>
 findPatternOccurrences(PatternIt pat_first, PatternIt pat_last,
@@ -29,44 +477,405 @@ findPatternOccurrences(PatternIt pat_first, PatternIt pat_last,
     const Index m = std::distance(pat_first, pat_last);
     if (m == 0) return {};
 
-    auto prefix = calculatePrefixFunction(pat_first, pat_last);
+    if constexpr (ContiguousCharIterator<PatternIt> && ContiguousCharIterator<TextIt>) {
+        return findContiguousOccurrences<Index>(std::string(pat_first, pat_last),
+                                                std::to_address(text_first),
+                                                std::distance(text_first, text_last));
+    }
+
     std::vector<Index> occurrences;
-    Index matched = 0;
-    for (Index i = 0; i < std::distance(text_first, text_last); ++i) {
-        while (matched > 0 && *(pat_first + matched) != *(text_first + i)) {
-            matched = prefix[matched - 1];
+    forEachPatternOccurrence(pat_first, pat_last, text_first, text_last,
+                             [&occurrences](Index position) { occurrences.push_back(position); });
+    return occurrences;
+}
+
+std::vector<std::ptrdiff_t> findPatternOccurrences(const std::string& pattern,
+                                                   const std::string& text) {
+    return findPatternOccurrences(pattern.begin(), pattern.end(), text.begin(), text.end());
+}
+
+// Searches one window of the text at a time with the parallel search, so the
+// collected positions never exceed one window's worth.
+void printPatternOccurrences(const std::string& pattern, const std::string& text) {
+    if (pattern.empty()) return;
+    const std::size_t window =
+        std::max<std::size_t>(1, std::thread::hardware_concurrency()) * kParallelMinChunk;
+    for (std::size_t begin = 0; begin < text.size(); begin += window) {
+        const std::size_t length = std::min(text.size() - begin, window + pattern.size() - 1);
+        for (std::size_t position :
+             findContiguousOccurrences<std::size_t>(pattern, text.data() + begin, length)) {
+            std::cout << begin + position << "\n";
+        }
+    }
+}
+
+std::size_t readTokenChunk(std::istream& in, char* buffer, std::size_t capacity) {
+    std::streambuf* source = in.rdbuf();
+    std::size_t length = 0;
+    while (length < capacity) {
+        int c = source->sgetc();
+        if (c == std::char_traits<char>::eof() || std::isspace(c)) {
+            break;
+        }
+        buffer[length++] = static_cast<char>(c);
+        source->sbumpc();
+    }
+    return length;
+}
+
+bool streamPatternOccurrences(std::istream& in) {
+    const std::istream::pos_type text_start = in.tellg();
+    if (text_start == std::istream::pos_type(-1)) {
+        return false;
+    }
+
+    std::vector<char> chunk(kStreamChunkSize);
+    in >> std::ws;
+    while (readTokenChunk(in, chunk.data(), chunk.size()) > 0) {
+    }
+    std::string pattern;
+    in >> pattern;
+    if (pattern.empty()) {
+        return true;
+    }
+
+    in.clear();
+    in.seekg(text_start);
+    in >> std::ws;
+    StreamingPatternMatcher matcher(pattern);
+    std::size_t length;
+    while ((length = readTokenChunk(in, chunk.data(), chunk.size())) > 0) {
+        matcher.feed(chunk.data(), chunk.data() + length,
+                     [](long long position) { std::cout << position << "\n"; });
+    }
+    return true;
+}
+
+std::vector<std::int32_t> buildSuffixArray(const std::vector<std::int32_t>& s, std::int32_t upper) {
+    const std::int32_t n = static_cast<std::int32_t>(s.size());
+    if (n == 0) return {};
+    if (n == 1) return {0};
+    if (n == 2) return s[0] < s[1] ? std::vector<std::int32_t>{0, 1} : std::vector<std::int32_t>{1, 0};
+
+    std::vector<std::int32_t> sa(n);
+    std::vector<bool> is_s_type(n, false);
+    for (std::int32_t i = n - 2; i >= 0; --i) {
+        is_s_type[i] = s[i] == s[i + 1] ? is_s_type[i + 1] : s[i] < s[i + 1];
+    }
+    std::vector<std::int32_t> bucket_l(upper + 1, 0), bucket_s(upper + 1, 0);
+    for (std::int32_t i = 0; i < n; ++i) {
+        if (is_s_type[i]) {
+            ++bucket_l[s[i] + 1];
+        } else {
+            ++bucket_s[s[i]];
+        }
+    }
+    for (std::int32_t c = 0; c <= upper; ++c) {
+        bucket_s[c] += bucket_l[c];
+        if (c < upper) {
+            bucket_l[c + 1] += bucket_s[c];
+        }
+    }
+
+    auto induce = [&](const std::vector<std::int32_t>& lms) {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::vector<std::int32_t> head(bucket_s);
+        for (std::int32_t d : lms) {
+            if (d != n) {
+                sa[head[s[d]]++] = d;
+            }
         }
-        if (*(pat_first + matched) == *(text_first + i)) {
-            ++matched;
+        head = bucket_l;
+        sa[head[s[n - 1]]++] = n - 1;
+        for (std::int32_t i = 0; i < n; ++i) {
+            std::int32_t v = sa[i];
+            if (v >= 1 && !is_s_type[v - 1]) {
+                sa[head[s[v - 1]]++] = v - 1;
+            }
         }
-        if (matched == m) {
-            occurrences.push_back(i - m + 1);
-            matched = prefix[matched - 1];
+        head = bucket_l;
+        for (std::int32_t i = n - 1; i >= 0; --i) {
+            std::int32_t v = sa[i];
+            if (v >= 1 && is_s_type[v - 1]) {
+                sa[--head[s[v - 1] + 1]] = v - 1;
+            }
+        }
+    };
+
+    std::vector<std::int32_t> lms_index(n + 1, -1);
+    std::vector<std::int32_t> lms;
+    for (std::int32_t i = 1; i < n; ++i) {
+        if (!is_s_type[i - 1] && is_s_type[i]) {
+            lms_index[i] = static_cast<std::int32_t>(lms.size());
+            lms.push_back(i);
         }
     }
-    return occurrences;
+    const std::int32_t lms_count = static_cast<std::int32_t>(lms.size());
+    induce(lms);
+
+    if (lms_count > 0) {
+        std::vector<std::int32_t> sorted_lms;
+        sorted_lms.reserve(lms_count);
+        for (std::int32_t v : sa) {
+            if (lms_index[v] != -1) {
+                sorted_lms.push_back(v);
+            }
+        }
+        std::vector<std::int32_t> reduced(lms_count);
+        std::int32_t reduced_upper = 0;
+        reduced[lms_index[sorted_lms[0]]] = 0;
+        for (std::int32_t i = 1; i < lms_count; ++i) {
+            std::int32_t l = sorted_lms[i - 1];
+            std::int32_t r = sorted_lms[i];
+            const std::int32_t end_l = lms_index[l] + 1 < lms_count ? lms[lms_index[l] + 1] : n;
+            const std::int32_t end_r = lms_index[r] + 1 < lms_count ? lms[lms_index[r] + 1] : n;
+            bool same = end_l - l == end_r - r;
+            if (same) {
+                while (l < end_l && s[l] == s[r]) {
+                    ++l;
+                    ++r;
+                }
+                same = l != n && s[l] == s[r];
+            }
+            if (!same) {
+                ++reduced_upper;
+            }
+            reduced[lms_index[sorted_lms[i]]] = reduced_upper;
+        }
+
+        auto reduced_sa = buildSuffixArray(reduced, reduced_upper);
+        for (std::int32_t i = 0; i < lms_count; ++i) {
+            sorted_lms[i] = lms[reduced_sa[i]];
+        }
+        induce(sorted_lms);
+    }
+    return sa;
 }
 
-std::vector<int> findPatternOccurrences(const std::string& pattern,
-                                        const std::string& text) {
-    auto raw_occurrences = findPatternOccurrences(
-        pattern.begin(), pattern.end(), text.begin(), text.end());
-    return std::vector<int>(raw_occurrences.begin(), raw_occurrences.end());
+std::vector<std::int32_t> buildLcpArray(const std::string& text,
+                                        const std::vector<std::int32_t>& sa) {
+    const std::size_t n = text.size();
+    std::vector<std::int32_t> rank(n), lcp(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        rank[sa[i]] = static_cast<std::int32_t>(i);
+    }
+    std::size_t h = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (h > 0) {
+            --h;
+        }
+        if (rank[i] == 0) {
+            h = 0;
+            continue;
+        }
+        const std::size_t j = sa[rank[i] - 1];
+        while (i + h < n && j + h < n && text[i + h] == text[j + h]) {
+            ++h;
+        }
+        lcp[rank[i]] = static_cast<std::int32_t>(h);
+    }
+    return lcp;
 }
 
-void printVector(const std::vector<int>& vec) {
-    for (int idx : vec) {
-        std::cout << idx << "\n";
+class SuffixArrayIndex {
+public:
+    static void build(const std::string& text, const std::string& path) {
+        if (text.size() > static_cast<std::size_t>(INT32_MAX)) {
+            throw std::runtime_error("text is too long for a 32-bit suffix array index");
+        }
+        std::vector<std::int32_t> symbols(text.begin(), text.end());
+        for (std::int32_t& c : symbols) {
+            c = static_cast<unsigned char>(c);
+        }
+        const auto sa = buildSuffixArray(symbols, 255);
+        symbols.clear();
+        symbols.shrink_to_fit();
+        const auto lcp = buildLcpArray(text, sa);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("cannot create index file " + path);
+        }
+        const std::uint64_t length = text.size();
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        const char padding[sizeof(std::int32_t)] = {};
+        out.write(padding, static_cast<std::streamsize>(paddingFor(text.size())));
+        out.write(reinterpret_cast<const char*>(sa.data()),
+                  static_cast<std::streamsize>(sa.size() * sizeof(std::int32_t)));
+        out.write(reinterpret_cast<const char*>(lcp.data()),
+                  static_cast<std::streamsize>(lcp.size() * sizeof(std::int32_t)));
+        if (!out) {
+            throw std::runtime_error("cannot write index file " + path);
+        }
+    }
+
+    explicit SuffixArrayIndex(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open index file " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kHeaderSize) {
+            ::close(fd);
+            throw std::runtime_error("index file " + path + " is truncated");
+        }
+        mapped_size = static_cast<std::size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("cannot map index file " + path);
+        }
+        base = static_cast<const char*>(mapped);
+
+        std::uint64_t length = 0;
+        std::memcpy(&length, base + sizeof(kMagic), sizeof(length));
+        text_length = length;
+        const std::size_t arrays = kHeaderSize + text_length + paddingFor(text_length);
+        if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0 ||
+            mapped_size != arrays + 2 * text_length * sizeof(std::int32_t)) {
+            ::munmap(const_cast<char*>(base), mapped_size);
+            throw std::runtime_error("index file " + path + " is corrupt");
+        }
+        text = base + kHeaderSize;
+        sa = reinterpret_cast<const std::int32_t*>(base + arrays);
+        lcp = sa + text_length;
+    }
+
+    SuffixArrayIndex(const SuffixArrayIndex&) = delete;
+    SuffixArrayIndex& operator=(const SuffixArrayIndex&) = delete;
+
+    ~SuffixArrayIndex() { ::munmap(const_cast<char*>(base), mapped_size); }
+
+    std::vector<long long> find(const std::string& pattern) const {
+        const std::size_t m = pattern.size();
+        std::vector<long long> occurrences;
+        if (m == 0 || m > text_length) {
+            return occurrences;
+        }
+
+        std::size_t lo = 0;
+        std::size_t hi = text_length;
+        std::size_t lo_common = 0;
+        std::size_t hi_common = 0;
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            const std::size_t common = commonPrefix(pattern, sa[mid], std::min(lo_common, hi_common));
+            if (common == m || (sa[mid] + common < text_length &&
+                                static_cast<unsigned char>(text[sa[mid] + common]) >
+                                    static_cast<unsigned char>(pattern[common]))) {
+                hi = mid;
+                hi_common = common;
+            } else {
+                lo = mid + 1;
+                lo_common = common;
+            }
+        }
+
+        if (lo == text_length || commonPrefix(pattern, sa[lo], 0) < m) {
+            return occurrences;
+        }
+        occurrences.push_back(sa[lo]);
+        for (std::size_t i = lo + 1; i < text_length && static_cast<std::size_t>(lcp[i]) >= m; ++i) {
+            occurrences.push_back(sa[i]);
+        }
+        std::sort(occurrences.begin(), occurrences.end());
+        return occurrences;
     }
+
+private:
+    static constexpr char kMagic[8] = {'K', 'M', 'P', 'S', 'A', 'I', 'X', '1'};
+    static constexpr std::size_t kHeaderSize = sizeof(kMagic) + sizeof(std::uint64_t);
+
+    static std::size_t paddingFor(std::size_t length) {
+        return (sizeof(std::int32_t) - (kHeaderSize + length) % sizeof(std::int32_t)) %
+               sizeof(std::int32_t);
+    }
+
+    std::size_t commonPrefix(const std::string& pattern, std::size_t suffix, std::size_t known) const {
+        while (known < pattern.size() && suffix + known < text_length &&
+               text[suffix + known] == pattern[known]) {
+            ++known;
+        }
+        return known;
+    }
+
+    const char* base = nullptr;
+    std::size_t mapped_size = 0;
+    std::size_t text_length = 0;
+    const char* text = nullptr;
+    const std::int32_t* sa = nullptr;
+    const std::int32_t* lcp = nullptr;
+};
+
+bool checkOccurrenceApis() {
+    const std::string pattern = "ab";
+    std::string text;
+    for (std::size_t i = 0; i < 3 * kParallelMinChunk / pattern.size(); ++i) {
+        text += pattern;
+    }
+    const std::size_t expected = text.size() / pattern.size();
+
+    std::vector<std::ptrdiff_t> first_matches;
+    forEachPatternOccurrence(pattern, text, [&first_matches](std::ptrdiff_t position) {
+        first_matches.push_back(position);
+        return false;
+    });
+    const std::size_t counted = countPatternOccurrences(pattern, text);
+    const std::size_t found = findPatternOccurrences(pattern, text).size();
+
+    const bool all_equal = first_matches == std::vector<std::ptrdiff_t>{0} &&
+                           counted == expected && found == expected;
+    if (!all_equal) {
+        std::cout << "first matches " << first_matches.size() << ", count " << counted
+                  << ", find " << found << ", expected " << expected << "\n";
+    }
+    std::cout << (all_equal ? "OK" : "MISMATCH") << "\n";
+    return all_equal;
 }
 
-int main() {
+int runIndexCommand(const std::string& command, const std::string& path) {
+    try {
+        if (command == "--build-index") {
+            std::string text;
+            std::cin >> text;
+            SuffixArrayIndex::build(text, path);
+            return 0;
+        }
+        SuffixArrayIndex index(path);
+        std::string pattern;
+        while (std::cin >> pattern) {
+            for (const auto position : index.find(pattern)) {
+                std::cout << position << "\n";
+            }
+        }
+        return 0;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
+    if (argc == 3 && (std::string(argv[1]) == "--build-index" ||
+                      std::string(argv[1]) == "--query")) {
+        return runIndexCommand(argv[1], argv[2]);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        return checkOccurrenceApis() ? 0 : 1;
+    }
+
+    if (streamPatternOccurrences(std::cin)) {
+        return 0;
+    }
+
     std::string text, pattern;
     std::cin >> text >> pattern;
-    auto result = findPatternOccurrences(pattern, text);
-    printVector(result);
+    printPatternOccurrences(pattern, text);
     return 0;
 }
\ No newline at end of file
@@ -1,10 +1,24 @@
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
 namespace GeoAnalysis {
 
+constexpr size_t kQueryBlockSize = 4096;
+constexpr long long kLaneCoordinateLimit = 1LL << 30;
+
 template <typename T>
 struct Point2D {
     T x;
@@ -74,61 +88,213 @@ public:
     }
 };
 
-class PointInPolygonTester {
+template <typename T>
+class DeletableUpperHull {
 public:
-    template <typename T>
-    static bool isInsidePolygon(const Point2D<T>& point, const Polygon<T>& polygon) {
-        if (polygon.size() < 3) return false;
+    explicit DeletableUpperHull(Polygon<T> sortedPoints) : points(std::move(sortedPoints)) {
+        while (leafBase < points.size()) leafBase <<= 1;
+        nodes.assign(2 * leafBase, {-1, -1, -1, -1});
+        for (size_t i = 0; i < points.size(); ++i) {
+            const int index = static_cast<int>(i);
+            nodes[leafBase + i] = {index, index, index, index};
+        }
+        for (size_t node = leafBase - 1; node >= 1; --node) {
+            pull(node);
+        }
+    }
+
+    void erase(const std::vector<int>& indices) {
+        std::vector<size_t> dirty;
+        for (int index : indices) {
+            const size_t node = leafBase + index;
+            nodes[node].first = nodes[node].last = -1;
+            dirty.push_back(node / 2);
+        }
+        while (!dirty.empty() && dirty.front() >= 1) {
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+            for (size_t node : dirty) {
+                pull(node);
+            }
+            for (size_t& node : dirty) {
+                node /= 2;
+            }
+        }
+    }
+
+    std::vector<int> hullIndices() const {
+        std::vector<int> hull;
+        if (nodes[1].first >= 0) collect(1, nodes[1].first, nodes[1].last, hull);
+        return hull;
+    }
+
+private:
+    struct Node {
+        int first;
+        int last;
+        int bridgeLeft;
+        int bridgeRight;
+    };
 
-        for (size_t i = 0; i < polygon.size(); ++i) {
-            const Point2D<T>& current = polygon[i];
-            const Point2D<T>& next = polygon[(i + 1) % polygon.size()];
-            if (MathUtils::isPointOnSegment(current, next, point)) 
-                return true;
+    Polygon<T> points;
+    size_t leafBase = 1;
+    std::vector<Node> nodes;
+
+    T orientation(int a, int b, int c) const {
+        return MathUtils::crossProduct(points[b] - points[a], points[c] - points[a]);
+    }
+
+    // True when the lines (a0, a1) and (b0, b1) meet at or lexicographically before split.
+    static bool meetsBeforeSplit(const Point2D<T>& a0, const Point2D<T>& a1, const Point2D<T>& b0,
+                                 const Point2D<T>& b1, const Point2D<T>& split) {
+        using Wide = __int128;
+        const Wide dxa = Wide(a1.x) - a0.x, dya = Wide(a1.y) - a0.y;
+        const Wide dxb = Wide(b1.x) - b0.x, dyb = Wide(b1.y) - b0.y;
+        const Wide denominator = dxa * dyb - dya * dxb;
+        if (denominator == 0) return true;
+        const Wide numerator = (Wide(b0.x) - a0.x) * dyb - (Wide(b0.y) - a0.y) * dxb;
+        Wide offsetX = (Wide(a0.x) - split.x) * denominator + dxa * numerator;
+        Wide offsetY = (Wide(a0.y) - split.y) * denominator + dya * numerator;
+        if (denominator < 0) {
+            offsetX = -offsetX;
+            offsetY = -offsetY;
         }
+        return offsetX < 0 || (offsetX == 0 && offsetY <= 0);
+    }
 
-        int crossings = 0;
-        for (size_t i = 0; i < polygon.size(); ++i) {
-            const Point2D<T>& current = polygon[i];
-            const Point2D<T>& next = polygon[(i + 1) % polygon.size()];
-            
-            if ((current.y > point.y) != (next.y > point.y)) {
-                double xIntersect = current.x + (double)(point.y - current.y) * 
-                                    (next.x - current.x) / (next.y - current.y);
-                if (point.x < xIntersect) crossings++;
+    size_t settle(size_t node) const {
+        while (node < leafBase && (nodes[2 * node].first < 0 || nodes[2 * node + 1].first < 0)) {
+            node = nodes[2 * node].first >= 0 ? 2 * node : 2 * node + 1;
+        }
+        return node;
+    }
+
+    void pull(size_t node) {
+        Node& current = nodes[node];
+        const Node& left = nodes[2 * node];
+        const Node& right = nodes[2 * node + 1];
+        current.first = left.first >= 0 ? left.first : right.first;
+        current.last = right.last >= 0 ? right.last : left.last;
+        if (left.first < 0 || right.first < 0) return;
+        // Deletions never lift a point above a bridge whose endpoints both survive.
+        if (current.bridgeLeft >= 0 && nodes[leafBase + current.bridgeLeft].first >= 0 &&
+            nodes[leafBase + current.bridgeRight].first >= 0) {
+            return;
+        }
+
+        size_t a = settle(2 * node), b = settle(2 * node + 1);
+        while (a < leafBase || b < leafBase) {
+            const Node& hullA = nodes[a];
+            const Node& hullB = nodes[b];
+            const bool aSplit = a < leafBase, bSplit = b < leafBase;
+            if (aSplit && orientation(hullA.bridgeLeft, hullA.bridgeRight, hullB.bridgeLeft) > 0) {
+                a = settle(2 * a);
+            } else if (bSplit && orientation(hullA.bridgeRight, hullB.bridgeLeft, hullB.bridgeRight) > 0) {
+                b = settle(2 * b + 1);
+            } else if (!aSplit) {
+                b = settle(2 * b);
+            } else if (!bSplit) {
+                a = settle(2 * a + 1);
+            } else if (meetsBeforeSplit(points[hullA.bridgeLeft], points[hullA.bridgeRight],
+                                        points[hullB.bridgeLeft], points[hullB.bridgeRight],
+                                        points[left.last])) {
+                a = settle(2 * a + 1);
+            } else {
+                b = settle(2 * b);
             }
         }
-        return (crossings % 2) == 1;
+        current.bridgeLeft = static_cast<int>(a - leafBase);
+        current.bridgeRight = static_cast<int>(b - leafBase);
+    }
+
+    void collect(size_t node, int from, int to, std::vector<int>& hull) const {
+        node = settle(node);
+        if (node >= leafBase) {
+            hull.push_back(static_cast<int>(node - leafBase));
+            return;
+        }
+        const Node& current = nodes[node];
+        if (from <= current.bridgeLeft) collect(2 * node, from, std::min(to, current.bridgeLeft), hull);
+        if (to >= current.bridgeRight) collect(2 * node + 1, std::max(from, current.bridgeRight), to, hull);
     }
 };
 
-class ZoneAnalyzer {
+class ConvexLayerBuilder {
 public:
     template <typename T>
-    static std::vector<int> calculateZones(const Polygon<T>& landmarks, const std::vector<Point2D<T>>& queries) {
-        std::vector<Point2D<T>> remainingPoints = landmarks;
-        std::vector<int> zoneResults(queries.size(), 0);
-        int currentZoneLevel = 0;
-
-        while (remainingPoints.size() >= 3) {
-            Polygon<T> currentHull = ConvexHullBuilder::computeConvexHull(remainingPoints);
-            
-            for (size_t i = 0; i < queries.size(); ++i) {
-                if (zoneResults[i] == currentZoneLevel && 
-                    PointInPolygonTester::isInsidePolygon(queries[i], currentHull)) {
-                    zoneResults[i] = currentZoneLevel + 1;
+    static std::vector<Polygon<T>> computeConvexLayers(Polygon<T> points) {
+        static_assert(std::is_integral_v<T>, "convex layers use exact integer predicates");
+        auto lexLess = [](const Point2D<T>& a, const Point2D<T>& b) {
+            return std::tie(a.x, a.y) < std::tie(b.x, b.y);
+        };
+        std::sort(points.begin(), points.end(), lexLess);
+        points.erase(std::unique(points.begin(), points.end(),
+                                 [](const Point2D<T>& a, const Point2D<T>& b) {
+                                     return a.x == b.x && a.y == b.y;
+                                 }),
+                     points.end());
+
+        const int n = static_cast<int>(points.size());
+        Polygon<T> mirrored(n);
+        for (int i = 0; i < n; ++i) {
+            mirrored[i] = {-points[n - 1 - i].x, -points[n - 1 - i].y};
+        }
+        DeletableUpperHull<T> upper(points);
+        DeletableUpperHull<T> lower(std::move(mirrored));
+
+        std::vector<Polygon<T>> layers;
+        while (true) {
+            const std::vector<int> upperChain = upper.hullIndices();
+            const std::vector<int> lowerChain = lower.hullIndices();
+            if (upperChain.size() < 2) break;
+
+            std::vector<int> boundary;
+            for (auto it = lowerChain.rbegin(); it != lowerChain.rend(); ++it) {
+                boundary.push_back(n - 1 - *it);
+            }
+            for (size_t i = upperChain.size() - 2; i >= 1; --i) {
+                boundary.push_back(upperChain[i]);
+            }
+
+            Polygon<T> layer;
+            for (size_t i = 0; i < boundary.size(); ++i) {
+                const Point2D<T>& prev = points[boundary[(i + boundary.size() - 1) % boundary.size()]];
+                const Point2D<T>& current = points[boundary[i]];
+                const Point2D<T>& next = points[boundary[(i + 1) % boundary.size()]];
+                if (MathUtils::crossProduct(current - prev, next - current) != 0) {
+                    layer.push_back(current);
                 }
             }
+            if (layer.size() < 3) break;
 
-            removeHullPoints(remainingPoints, currentHull);
-            currentZoneLevel++;
-        }
+            std::rotate(layer.begin(),
+                        std::min_element(layer.begin(), layer.end(),
+                                         [](const Point2D<T>& a, const Point2D<T>& b) {
+                                             return std::tie(a.y, a.x) < std::tie(b.y, b.x);
+                                         }),
+                        layer.end());
+            layers.push_back(std::move(layer));
 
-        for (auto& zone : zoneResults) {
-            zone = std::max(zone - 1, 0);
+            std::vector<int> mirroredBoundary(boundary.size());
+            for (size_t i = 0; i < boundary.size(); ++i) {
+                mirroredBoundary[i] = n - 1 - boundary[i];
+            }
+            upper.erase(boundary);
+            lower.erase(mirroredBoundary);
         }
+        return layers;
+    }
 
-        return zoneResults;
+    template <typename T>
+    static std::vector<Polygon<T>> peelLayersByRebuilding(Polygon<T> points) {
+        std::vector<Polygon<T>> layers;
+        while (points.size() >= 3) {
+            Polygon<T> hull = ConvexHullBuilder::computeConvexHull(points);
+            removeHullPoints(points, hull);
+            if (hull.size() < 3) break;
+            layers.push_back(std::move(hull));
+        }
+        return layers;
     }
 
 private:
@@ -147,11 +313,262 @@ private:
     }
 };
 
+class PointInPolygonTester {
+public:
+    template <typename T>
+    static bool isInsideConvexPolygon(const Point2D<T>& point, const Polygon<T>& polygon) {
+        const size_t n = polygon.size();
+        if (n < 3) return false;
+
+        const Point2D<T>& origin = polygon[0];
+        const T firstTurn = MathUtils::crossProduct(polygon[1] - origin, point - origin);
+        const T lastTurn = MathUtils::crossProduct(polygon[n - 1] - origin, point - origin);
+        if (firstTurn < 0 || lastTurn > 0) return false;
+        if (firstTurn == 0) return MathUtils::isPointOnSegment(origin, polygon[1], point);
+        if (lastTurn == 0) return MathUtils::isPointOnSegment(origin, polygon[n - 1], point);
+
+        size_t low = 1, high = n - 1;
+        while (high - low > 1) {
+            const size_t mid = (low + high) / 2;
+            if (MathUtils::crossProduct(polygon[mid] - origin, point - origin) >= 0) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return MathUtils::crossProduct(polygon[high] - polygon[low], point - polygon[low]) >= 0;
+    }
+};
+
+template <typename T>
+class ConvexLayerIndex {
+public:
+    explicit ConvexLayerIndex(std::vector<Polygon<T>> nestedLayers) : layers(std::move(nestedLayers)) {
+        layerOffset.push_back(0);
+        for (const Polygon<T>& layer : layers) {
+            for (const Point2D<T>& vertex : layer) {
+                vertexX.push_back(vertex.x);
+                vertexY.push_back(vertex.y);
+                verticesFitLanes = verticesFitLanes && fitsLane(vertex);
+            }
+            layerOffset.push_back(static_cast<long long>(vertexX.size()));
+            while ((size_t{1} << vertexSteps) < layer.size()) ++vertexSteps;
+        }
+    }
+
+    int zoneOf(const Point2D<T>& point) const {
+        size_t low = 0, high = layers.size();
+        while (low < high) {
+            const size_t mid = (low + high) / 2;
+            if (PointInPolygonTester::isInsideConvexPolygon(point, layers[mid])) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return std::max(static_cast<int>(low) - 1, 0);
+    }
+
+    std::vector<int> zonesOf(const std::vector<Point2D<T>>& queries, unsigned threadCount) const {
+        std::vector<int> zones(queries.size(), 0);
+        const size_t blocks = (queries.size() + kQueryBlockSize - 1) / kQueryBlockSize;
+        const size_t workers = std::clamp<size_t>(threadCount, 1, std::max<size_t>(blocks, 1));
+        auto locateBlocks = [&](size_t worker) {
+            for (size_t block = worker; block < blocks; block += workers) {
+                const size_t begin = block * kQueryBlockSize;
+                locateBlock(queries, zones, begin, std::min(queries.size(), begin + kQueryBlockSize));
+            }
+        };
+
+        if (workers == 1) {
+            locateBlocks(0);
+            return zones;
+        }
+        std::vector<std::thread> pool;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            pool.emplace_back(locateBlocks, worker);
+        }
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        return zones;
+    }
+
+private:
+    std::vector<Polygon<T>> layers;
+    std::vector<T> vertexX;
+    std::vector<T> vertexY;
+    std::vector<long long> layerOffset;
+    int vertexSteps = 0;
+    bool verticesFitLanes = true;
+
+    static bool fitsLane(const Point2D<T>& point) {
+        return point.x >= -kLaneCoordinateLimit && point.x < kLaneCoordinateLimit &&
+               point.y >= -kLaneCoordinateLimit && point.y < kLaneCoordinateLimit;
+    }
+
+    void locateBlock(const std::vector<Point2D<T>>& queries, std::vector<int>& zones, size_t begin,
+                     size_t end) const {
+        size_t i = begin;
+#ifdef HAVE_X86_SIMD
+        if constexpr (std::is_same_v<T, long long>) {
+            if (verticesFitLanes && !layers.empty() && __builtin_cpu_supports("avx2")) {
+                for (; i + 4 <= end; i += 4) {
+                    if (fitsLane(queries[i]) && fitsLane(queries[i + 1]) && fitsLane(queries[i + 2]) &&
+                        fitsLane(queries[i + 3])) {
+                        locateFourAvx2(&queries[i], &zones[i]);
+                    } else {
+                        for (size_t k = i; k < i + 4; ++k) zones[k] = zoneOf(queries[k]);
+                    }
+                }
+            }
+        }
+#endif
+        for (; i < end; ++i) {
+            zones[i] = zoneOf(queries[i]);
+        }
+    }
+
+#ifdef HAVE_X86_SIMD
+    __attribute__((target("avx2")))
+    static __m256i crossLanes(__m256i ax, __m256i ay, __m256i bx, __m256i by) {
+        return _mm256_sub_epi64(_mm256_mul_epi32(ax, by), _mm256_mul_epi32(ay, bx));
+    }
+
+    // Tests four queries against one layer each; lanes whose point lies on the line through
+    // the first or last edge of the fan are flagged for the scalar test.
+    __attribute__((target("avx2")))
+    void testFourLayers(__m256i queryX, __m256i queryY, const long long* layer, int& insideMask,
+                        int& degenerateMask) const {
+        const long long* xs = reinterpret_cast<const long long*>(vertexX.data());
+        const long long* ys = reinterpret_cast<const long long*>(vertexY.data());
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi64x(1);
+
+        const __m256i layerId = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(layer));
+        const __m256i origin = _mm256_i64gather_epi64(layerOffset.data(), layerId, 8);
+        const __m256i last = _mm256_sub_epi64(_mm256_i64gather_epi64(layerOffset.data() + 1, layerId, 8), one);
+        const __m256i originX = _mm256_i64gather_epi64(xs, origin, 8);
+        const __m256i originY = _mm256_i64gather_epi64(ys, origin, 8);
+        const __m256i deltaX = _mm256_sub_epi64(queryX, originX);
+        const __m256i deltaY = _mm256_sub_epi64(queryY, originY);
+
+        auto turnAt = [&](__m256i vertex) __attribute__((target("avx2"))) {
+            return crossLanes(_mm256_sub_epi64(_mm256_i64gather_epi64(xs, vertex, 8), originX),
+                              _mm256_sub_epi64(_mm256_i64gather_epi64(ys, vertex, 8), originY), deltaX, deltaY);
+        };
+        const __m256i firstTurn = turnAt(_mm256_add_epi64(origin, one));
+        const __m256i lastTurn = turnAt(last);
+        const __m256i outside =
+            _mm256_or_si256(_mm256_cmpgt_epi64(zero, firstTurn), _mm256_cmpgt_epi64(lastTurn, zero));
+        const __m256i onFanEdge =
+            _mm256_or_si256(_mm256_cmpeq_epi64(firstTurn, zero), _mm256_cmpeq_epi64(lastTurn, zero));
+
+        __m256i low = _mm256_add_epi64(origin, one);
+        __m256i high = last;
+        for (int step = 0; step < vertexSteps; ++step) {
+            const __m256i active = _mm256_cmpgt_epi64(_mm256_sub_epi64(high, low), one);
+            const __m256i mid = _mm256_srli_epi64(_mm256_add_epi64(low, high), 1);
+            const __m256i turnsLeft = _mm256_cmpgt_epi64(zero, turnAt(mid));
+            low = _mm256_blendv_epi8(low, mid, _mm256_andnot_si256(turnsLeft, active));
+            high = _mm256_blendv_epi8(high, mid, _mm256_and_si256(turnsLeft, active));
+        }
+
+        const __m256i lowX = _mm256_i64gather_epi64(xs, low, 8);
+        const __m256i lowY = _mm256_i64gather_epi64(ys, low, 8);
+        const __m256i edgeTurn = crossLanes(_mm256_sub_epi64(_mm256_i64gather_epi64(xs, high, 8), lowX),
+                                            _mm256_sub_epi64(_mm256_i64gather_epi64(ys, high, 8), lowY),
+                                            _mm256_sub_epi64(queryX, lowX), _mm256_sub_epi64(queryY, lowY));
+        const __m256i inside = _mm256_andnot_si256(_mm256_or_si256(outside, _mm256_cmpgt_epi64(zero, edgeTurn)),
+                                                   _mm256_set1_epi64x(-1));
+        insideMask = _mm256_movemask_pd(_mm256_castsi256_pd(inside));
+        degenerateMask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(outside, onFanEdge)));
+    }
+
+    __attribute__((target("avx2")))
+    void locateFourAvx2(const Point2D<T>* queries, int* zones) const {
+        const __m256i queryX = _mm256_set_epi64x(queries[3].x, queries[2].x, queries[1].x, queries[0].x);
+        const __m256i queryY = _mm256_set_epi64x(queries[3].y, queries[2].y, queries[1].y, queries[0].y);
+        const long long layerCount = static_cast<long long>(layers.size());
+        long long low[4] = {0, 0, 0, 0};
+        long long high[4] = {layerCount, layerCount, layerCount, layerCount};
+        while (low[0] < high[0] || low[1] < high[1] || low[2] < high[2] || low[3] < high[3]) {
+            long long mid[4];
+            for (int k = 0; k < 4; ++k) {
+                mid[k] = low[k] < high[k] ? (low[k] + high[k]) / 2 : std::min(low[k], layerCount - 1);
+            }
+            int insideMask = 0, degenerateMask = 0;
+            testFourLayers(queryX, queryY, mid, insideMask, degenerateMask);
+            for (int k = 0; k < 4; ++k) {
+                if (low[k] >= high[k]) continue;
+                const bool inside = (degenerateMask >> k) & 1
+                                        ? PointInPolygonTester::isInsideConvexPolygon(queries[k], layers[mid[k]])
+                                        : (insideMask >> k) & 1;
+                if (inside) {
+                    low[k] = mid[k] + 1;
+                } else {
+                    high[k] = mid[k];
+                }
+            }
+        }
+        for (int k = 0; k < 4; ++k) {
+            zones[k] = std::max(static_cast<int>(low[k]) - 1, 0);
+        }
+    }
+#endif
+};
+
+class ZoneAnalyzer {
+public:
+    template <typename T>
+    static std::vector<int> calculateZones(const Polygon<T>& landmarks, const std::vector<Point2D<T>>& queries) {
+        const ConvexLayerIndex<T> index(ConvexLayerBuilder::computeConvexLayers(landmarks));
+        return index.zonesOf(queries, std::thread::hardware_concurrency());
+    }
+};
+
+void runConvexLayerBenchmark(size_t maxLandmarks) {
+    std::mt19937_64 generator(2024);
+    std::uniform_int_distribution<long long> coordinate(-1000000000LL, 1000000000LL);
+    for (size_t count = 1000; count <= maxLandmarks; count *= 10) {
+        Polygon<long long> landmarks(count);
+        for (auto& p : landmarks) {
+            p = {coordinate(generator), coordinate(generator)};
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        const auto layers = ConvexLayerBuilder::computeConvexLayers(landmarks);
+        const std::chrono::duration<double> peeled = std::chrono::steady_clock::now() - start;
+        std::cout << "landmarks " << count << ": " << layers.size() << " layers, "
+                  << peeled.count() << " s";
+
+        if (count <= 20000) {
+            start = std::chrono::steady_clock::now();
+            const auto reference = ConvexLayerBuilder::peelLayersByRebuilding(landmarks);
+            const std::chrono::duration<double> rebuilt = std::chrono::steady_clock::now() - start;
+            bool same = reference.size() == layers.size();
+            for (size_t i = 0; same && i < layers.size(); ++i) {
+                same = std::equal(layers[i].begin(), layers[i].end(), reference[i].begin(), reference[i].end(),
+                                  [](const Point2D<long long>& a, const Point2D<long long>& b) {
+                                      return a.x == b.x && a.y == b.y;
+                                  });
+            }
+            std::cout << ", rebuilding " << rebuilt.count() << " s" << (same ? "" : ", MISMATCH");
+        }
+        std::cout << '\n';
+    }
+}
+
 } // namespace GeoAnalysis
 
-int main() {
+int main(int argc, char* argv[]) {
     using namespace GeoAnalysis;
 
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runConvexLayerBenchmark(argc > 2 ? std::stoull(argv[2]) : 1000000);
+        return 0;
+    }
+
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 